@@ -0,0 +1,84 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+std::string errMsg(errno_t en) {
+    return std::error_code{en, std::system_category()}.message();
+}
+
+struct Record {
+    std::uint32_t thread_id;
+    std::uint32_t seq;
+    char          payload[8];
+};
+
+int main() {
+    auto ph = fs::path("test.txt");
+    unsigned const thread_count = 8;
+    std::uint32_t const record_count = 100000;
+
+    MMapAppender appender;
+    if (auto en = appender.open(ph, 4096)) {
+        std::cout << "Appender open failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return -1;
+    }
+
+    std::vector<std::thread> writers;
+    for (unsigned t = 0; t < thread_count; ++t) {
+        writers.emplace_back([&appender, t, record_count] {
+            for (std::uint32_t i = 0; i < record_count; ++i) {
+                Record rec{t, i, "record"};
+                auto off = appender.append(reinterpret_cast<char const *>(&rec), sizeof(rec));
+                assert(off != MMapAppender::npos);
+            }
+        });
+    }
+    for (auto & w : writers) { w.join(); }
+
+    std::cout << "Appended: " << appender.size()
+        << ", capacity: " << appender.capacity() << std::endl;
+    assert(appender.size() == sizeof(Record) * thread_count * record_count);
+
+    appender.flush();
+    appender.close();
+
+    // the file is trimmed to the appended length
+    MMapFile mmfi;
+    mmfi.map(ph, AccessFlag::kReadOnly);
+    assert(mmfi.size() == sizeof(Record) * thread_count * record_count);
+
+    std::vector<std::uint32_t> next_seq(thread_count, 0);
+    auto const * p_rec = reinterpret_cast<Record const *>(mmfi.data());
+    for (size_t i = 0; i < mmfi.size() / sizeof(Record); ++i) {
+        // records of one thread keep their order
+        assert(p_rec[i].seq == next_seq[p_rec[i].thread_id]);
+        ++next_seq[p_rec[i].thread_id];
+    }
+    std::cout << "Records verified" << std::endl;
+
+    mmfi.unmap();
+    fs::remove(ph);
+    return 0;
+}
@@ -15,6 +15,7 @@
  */
 
 #include <iostream>
+#include <string>
 
 #include "aymmap/aymmap.hpp"
 
@@ -72,9 +73,54 @@ void bufRead() {
     std::cout << "Read byte: " << c << std::endl;
 }
 
+void bufFlushDirty() {
+    MMapFileBuf mmfb;
+    mmfb.map("test.txt", AccessFlag::kDefault, size_t(1) << 20);
+    assert(!mmfb.isDirty());
+
+    mmfb.seek(10, BufferPos::kBeg);
+    mmfb.write("abc", 3);
+    mmfb.seek(-10, BufferPos::kEnd);
+    mmfb.writeByte('z');
+    std::cout << "Dirty ranges: " << mmfb.dirtyPages().size() << std::endl;
+
+    // sync the touched pages only
+    mmfb.flushDirty();
+    assert(!mmfb.isDirty());
+}
+
+void bufLines() {
+    std::string const text = "first\nsecond\n\nlast";
+    {
+        MMapFile mmfi;
+        mmfi.map("test.txt", AccessFlag::kDefault | AccessFlag::kResize, text.size());
+        std::copy_n(text.data(), text.size(), mmfi.data());
+    }
+    MMapFileBuf mmfb;
+    mmfb.map("test.txt", AccessFlag::kReadOnly);
+
+    // zero-copy views, the position is left alone
+    size_t count = 0;
+    for (auto line : mmfb.lines()) {
+        std::cout << "Line: " << line;
+        ++count;
+    }
+    std::cout << std::endl;
+    assert(count == 4 && mmfb.tell() == 0);
+
+    // many lines per call
+    MMapFileBuf::view_type batch[3];
+    auto n = mmfb.readlines(batch, 3);
+    assert(n == 3 && batch[1] == "second\n");
+    n = mmfb.readlines(batch, 3);
+    assert(n == 1 && batch[0] == "last" && mmfb.isEOF());
+}
+
 int main() {
     bufWrite();
     bufRead();
+    bufFlushDirty();
+    bufLines();
     fs::remove("test.txt");
     return 0;
 }
@@ -0,0 +1,76 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+int main() {
+    constexpr std::size_t kCount = 1000000;
+    std::vector<std::uint32_t> ids(kCount);
+    std::vector<std::int64_t> timestamps(kCount);
+    for (std::size_t i = 0; i < kCount; ++i) {
+        ids[i] = std::uint32_t(500000 + (i * 7919) % 4096);
+        timestamps[i] = 1700000000000 + std::int64_t(i * 3 + i % 5);
+    }
+
+    std::size_t packed_size = 0;
+    {
+        MMapFileStream mmfs;
+        auto en = mmfs.map("test.txt", AccessFlag::kDefault, kCount * 12);
+        assert(!en);
+        mmfs.writeVarint(std::int32_t(-3)).writeVarint(std::uint64_t(300));
+        auto n_ids = mmfs.writePacked(std::span{ids});
+        auto n_timestamps = mmfs.writePacked(std::span{timestamps});
+        assert(n_ids == kCount && n_timestamps == kCount);
+        assert(mmfs.status() == MMapFileStream::Status::kOk);
+        packed_size = mmfs.buffer().tell();
+        std::cout << "raw: " << kCount * 12 << " bytes, packed: " << packed_size << " bytes" << std::endl;
+    }
+    {
+        MMapFileStream mmfs;
+        auto en = mmfs.map("test.txt", AccessFlag::kReadOnly);
+        assert(!en);
+        std::int32_t small = 0;
+        std::uint64_t medium = 0;
+        mmfs.readVarint(small).readVarint(medium);
+        assert(small == -3 && medium == 300);
+
+        std::vector<std::uint32_t> ids_in(kCount);
+        std::vector<std::int64_t> timestamps_in(kCount);
+        auto const beg = std::chrono::steady_clock::now();
+        auto n_ids = mmfs.readPacked(std::span{ids_in});
+        auto n_timestamps = mmfs.readPacked(std::span{timestamps_in});
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - beg;
+        std::cout << "decode: " << double(kCount * 12) / elapsed.count() / 1e9 << " GB/s" << std::endl;
+        assert(n_ids == kCount && n_timestamps == kCount);
+        assert(ids_in == ids && timestamps_in == timestamps);
+        assert(mmfs.buffer().tell() == packed_size);
+
+        // the output is too small, nothing is decoded
+        mmfs.buffer().seek(0, BufferPos::kBeg);
+        mmfs.readVarint(small).readVarint(medium);
+        n_ids = mmfs.readPacked(std::span{ids_in}.first(10));
+        assert(n_ids == 0);
+        assert(mmfs.status() == MMapFileStream::Status::kReadFailed);
+    }
+    fs::remove("test.txt");
+    return 0;
+}
@@ -0,0 +1,80 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+std::string errMsg(errno_t en) {
+    return std::error_code{en, std::system_category()}.message();
+}
+
+int main() {
+    auto ph = fs::path("test.txt");
+    size_t length = size_t(8) << 20; // 8MB
+
+    MMapFile mmfi;
+    if (auto en = mmfi.map(ph, AccessFlag::kDefault, length)) {
+        std::cout << "File map failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return -1;
+    }
+
+    FlushPolicy policy;
+    policy.interval = std::chrono::milliseconds(10);
+    policy.dirty_threshold = size_t(1) << 20;
+
+    MMapFlusher flusher(mmfi, policy);
+    if (auto en = flusher.start()) {
+        std::cout << "Flusher start failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return -1;
+    }
+
+    // writers keep streaming, write-back happens in background
+    size_t const record_size = 4096;
+    for (size_t off = 0; off < length / 2; off += record_size) {
+        std::fill_n(mmfi.data() + off, record_size, 'a');
+        flusher.markDirty(off, record_size);
+    }
+
+    // durability point
+    auto fut = flusher.syncPoint();
+    std::cout << "Sync point: " << errMsg(fut.get()) << std::endl;
+
+    for (size_t off = length / 2; off < length; off += record_size) {
+        std::fill_n(mmfi.data() + off, record_size, 'b');
+        flusher.markDirty(off, record_size);
+    }
+    flusher.syncPoint([](errno_t en) {
+        std::cout << "Sync point callback: " << errMsg(en) << std::endl;
+    });
+
+    flusher.stop();
+    assert(!flusher.isRunning());
+
+    // asynchronous flush without background thread
+    if (auto en = mmfi.flush(true)) {
+        std::cout << "Async flush failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+    }
+
+    mmfi.unmap();
+    fs::remove(ph);
+    return 0;
+}
@@ -0,0 +1,97 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+void unknownLength() {
+    MMapFileStream mmfs;
+    auto & buf = mmfs.buffer();
+    buf.setGrowthPolicy(GrowthPolicy{.kind = GrowthKind::kGeometric, .factor = 2.0});
+    auto en = mmfs.map("test.txt", AccessFlag::kDefault, 4096);
+    assert(!en);
+    // a fresh file is all padding, start the logical length at 0
+    buf.truncate(0);
+
+    std::uint64_t total = 0;
+    for (std::uint32_t i = 0; i < 100000; ++i) {
+        mmfs.writeVarint(i * 37);
+        total += i * 37;
+    }
+    mmfs << total;
+    assert(mmfs.status() == MMapFileStream::Status::kOk);
+    auto const length = buf.size();
+    std::cout << "logical: " << length << " bytes, capacity: " << buf.capacity() << " bytes" << std::endl;
+    assert(buf.capacity() >= length);
+
+    en = buf.close();
+    assert(!en && fs::file_size("test.txt") == length);
+
+    MMapFileStream reader;
+    en = reader.map("test.txt", AccessFlag::kReadOnly);
+    assert(!en);
+    std::uint64_t sum = 0;
+    for (std::uint32_t i = 0; i < 100000; ++i) {
+        std::uint32_t n = 0;
+        reader.readVarint(n);
+        sum += n;
+    }
+    std::uint64_t stored = 0;
+    reader >> stored;
+    assert(reader.status() == MMapFileStream::Status::kOk && stored == sum && sum == total);
+}
+
+void capped() {
+    MMapFileBuf buf;
+    buf.setGrowthPolicy(GrowthPolicy{
+        .kind = GrowthKind::kFixedStep, .step = 4096, .max_size = 3 * 4096});
+    auto en = buf.map("test.txt", AccessFlag::kDefault, 4096);
+    assert(!en);
+    buf.truncate(0);
+
+    std::string line(1000, 'x');
+    std::size_t written = 0;
+    while (auto n = buf.write(line.data(), line.size())) { written += n; }
+    std::cout << "capped at: " << written << " bytes" << std::endl;
+    assert(written == 3 * 4096 && buf.capacity() == 3 * 4096);
+}
+
+void privateCopy() {
+    MMapFileBuf buf;
+    buf.setGrowthPolicy(GrowthPolicy{.kind = GrowthKind::kGeometric});
+    auto en = buf.map("test.txt", AccessFlag::kWriteCopy);
+    assert(!en);
+    auto const length = buf.size();
+
+    // private writes are never stored, so the file must not grow either
+    std::string block(length + 1, 'y');
+    auto const written = buf.write(block.data(), block.size());
+    assert(written == length && buf.capacity() == length);
+    en = buf.close();
+    assert(!en && fs::file_size("test.txt") == length);
+}
+
+int main() {
+    unknownLength();
+    capped();
+    privateCopy();
+    fs::remove("test.txt");
+    return 0;
+}
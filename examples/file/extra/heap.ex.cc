@@ -0,0 +1,110 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <iostream>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+std::string errMsg(errno_t en) {
+    return std::error_code{en, std::system_category()}.message();
+}
+
+struct Node {
+    std::uint32_t     id;
+    std::uint32_t     degree;
+    OffsetPtr<Node>   next;
+    OffsetPtr<OffsetPtr<Node>> edges;
+};
+
+struct Graph {
+    std::uint32_t   node_count = 0;
+    OffsetPtr<Node> head;
+};
+
+int build(fs::path const & ph) {
+    MMapHeap heap;
+    if (auto en = heap.open(ph, 4096, size_t(1) << 30)) {
+        std::cout << "Heap open failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return -1;
+    }
+    assert(!heap.root<Graph>());
+    auto * p_graph = heap.construct<Graph>();
+    heap.setRoot(p_graph);
+
+    // a ring where every node links to its next two nodes
+    std::uint32_t const node_count = 10000;
+    Node * p_prev = nullptr;
+    for (std::uint32_t i = 0; i < node_count; ++i) {
+        auto * p_node = heap.construct<Node>();
+        p_node->id = i;
+        if (p_prev) { p_prev->next = p_node; } else { p_graph->head = p_node; }
+        p_prev = p_node;
+    }
+    for (auto * p = p_graph->head.get(); p; p = p->next.get()) {
+        p->degree = 2;
+        p->edges = static_cast<OffsetPtr<Node> *>(heap.allocate(sizeof(OffsetPtr<Node>) * 2));
+        auto * p_next = p->next ? p->next.get() : p_graph->head.get();
+        ::new (&p->edges[0]) OffsetPtr<Node>(p_next);
+        ::new (&p->edges[1]) OffsetPtr<Node>(p_next->next ? p_next->next.get() : p_graph->head.get());
+    }
+    p_graph->node_count = node_count;
+
+    // freed blocks are recycled
+    auto * p_tmp = heap.allocate(100);
+    heap.deallocate(p_tmp);
+    auto * p_reused = heap.allocate(120);
+    assert(p_reused == p_tmp);
+
+    std::cout << "Heap used: " << heap.used() << std::endl;
+    return heap.flush() ? -1 : 0;
+}
+
+int load(fs::path const & ph) {
+    // mapped at another address, without any deserialization
+    MMapHeap heap;
+    if (auto en = heap.open(ph)) {
+        std::cout << "Heap open failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return -1;
+    }
+    auto * p_graph = heap.root<Graph>();
+    assert(p_graph && p_graph->node_count == 10000);
+
+    std::uint64_t id_sum = 0;
+    std::uint32_t count = 0;
+    for (auto * p = p_graph->head.get(); p; p = p->next.get()) {
+        assert(p->edges[0]->id == (p->id + 1) % p_graph->node_count);
+        assert(p->edges[1]->id == (p->id + 2) % p_graph->node_count);
+        id_sum += p->id;
+        ++count;
+    }
+    assert(count == p_graph->node_count);
+    std::cout << "Loaded " << count << " nodes, id sum " << id_sum << std::endl;
+    return 0;
+}
+
+int main() {
+    auto ph = fs::path("test.txt");
+    fs::remove(ph);
+    if (build(ph)) { return -1; }
+    if (load(ph)) { return -1; }
+    fs::remove(ph);
+    return 0;
+}
@@ -0,0 +1,84 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+struct Sample {
+    std::uint64_t ts;
+    std::uint32_t sensor;
+    float         value;
+};
+
+struct Frame {
+    std::uint16_t kind;
+    Sample        sample;
+    std::uint8_t  quality[3];
+};
+
+AYMMAP_STREAM_LAYOUT(Sample, ts, sensor, value)
+AYMMAP_STREAM_LAYOUT(Frame, kind, sample, quality)
+
+template <Endian _endian>
+void roundTrip(char const * label) {
+    using Stream = BasicMMapFileStream<_endian>;
+    constexpr std::size_t kCount = 1000;
+    std::vector<Sample> samples(kCount);
+    for (std::size_t i = 0; i < kCount; ++i) {
+        samples[i] = Sample{1700000000000 + i, std::uint32_t(i % 16), float(i) / 8};
+    }
+    Frame frame{3, samples[42], {1, 2, 3}};
+
+    constexpr auto kSize = kCount * detail::kStreamSize<Sample> + detail::kStreamSize<Frame>;
+    {
+        Stream mmst;
+        auto en = mmst.map("test.txt", AccessFlag::kDefault, kSize);
+        assert(!en);
+        // one memcpy when the stream is native and Sample has no padding
+        auto n = mmst.writeArray(std::span{samples});
+        assert(n == kCount);
+        // Frame is padded in memory, so it is written field by field
+        mmst << frame;
+        assert(mmst.status() == Stream::Status::kOk && mmst.remaining() == 0);
+    }
+    {
+        Stream mmst;
+        auto en = mmst.map("test.txt", AccessFlag::kReadOnly);
+        assert(!en);
+        std::vector<Sample> samples_in(kCount);
+        Frame frame_in{};
+        auto n = mmst.readArray(std::span{samples_in});
+        assert(n == kCount);
+        mmst >> frame_in;
+        assert(mmst.status() == Stream::Status::kOk);
+        assert(samples_in[999].ts == samples[999].ts && samples_in[999].value == samples[999].value);
+        assert(frame_in.sample.sensor == frame.sample.sensor && frame_in.quality[2] == 3);
+        std::cout << label << ": " << kSize << " bytes, flat Sample: "
+            << detail::isFlatLayout<Sample>() << ", flat Frame: "
+            << detail::isFlatLayout<Frame>() << std::endl;
+    }
+}
+
+int main() {
+    roundTrip<Endian::native>("native");
+    roundTrip<Endian::native == Endian::little ? Endian::big : Endian::little>("foreign");
+    fs::remove("test.txt");
+    return 0;
+}
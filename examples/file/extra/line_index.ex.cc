@@ -0,0 +1,103 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+std::string errMsg(errno_t en) {
+    return std::error_code{en, std::system_category()}.message();
+}
+
+int main() {
+    auto ph = fs::path("test.txt");
+    auto idx_ph = fs::path("test.txt.idx");
+    size_t const line_count = 1000000;
+    {
+        std::ofstream ofs(ph, std::ios::binary);
+        for (size_t i = 0; i < line_count; ++i) {
+            ofs << "line " << i << ' ' << std::string(i % 97, '*') << '\n';
+        }
+    }
+
+    MMapFile mmfi;
+    if (auto en = mmfi.map(ph, AccessFlag::kReadOnly)) {
+        std::cout << "File map failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return -1;
+    }
+
+    MMapLineIndex index;
+    auto const t0 = std::chrono::steady_clock::now();
+    if (auto en = index.build(mmfi, ph, 4)) {
+        std::cout << "Index build failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return -1;
+    }
+    auto const t1 = std::chrono::steady_clock::now();
+    assert(index.size() == line_count);
+    std::cout << "Indexed " << index.size() << " lines in "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count() << "ms" << std::endl;
+
+    // jump to any line directly
+    for (size_t n : {size_t(0), size_t(63), size_t(64), size_t(123456), line_count - 1}) {
+        auto line = index.line(mmfi, n);
+        assert(line.starts_with("line " + std::to_string(n) + ' '));
+        assert(line.size() == 7 + std::to_string(n).size() + n % 97);
+    }
+    assert(index.line(mmfi, line_count).empty() && index.offset(line_count) == mmfi.size());
+
+    if (auto en = index.save(idx_ph)) {
+        std::cout << "Index save failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return -1;
+    }
+    std::cout << "Sidecar bytes: " << fs::file_size(idx_ph)
+        << " for " << mmfi.size() << " bytes of text" << std::endl;
+
+    MMapLineIndex loaded;
+    auto en = loaded.load(idx_ph, ph);
+    assert(!en && loaded.size() == line_count);
+    assert(loaded.line(mmfi, 777777) == index.line(mmfi, 777777));
+
+    // a changed file makes the sidecar stale
+    mmfi.unmap();
+    {
+        std::ofstream ofs(ph, std::ios::binary | std::ios::app);
+        ofs << "one more\n";
+    }
+    en = loaded.load(idx_ph, ph);
+    std::cout << "Load after append: " << en << std::endl;
+    assert(en == kEnoStale);
+
+    mmfi.map(ph, AccessFlag::kReadOnly);
+    en = loaded.loadOrBuild(mmfi, ph, idx_ph);
+    assert(!en && loaded.size() == line_count + 1);
+    assert(loaded.line(mmfi, line_count) == "one more\n");
+
+    mmfi.unmap();
+    loaded.clear();
+    index.clear();
+    assert(index.offset(0) == 0);
+    fs::remove(ph);
+    fs::remove(idx_ph);
+    return 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+std::string errMsg(errno_t en) {
+    return std::error_code{en, std::system_category()}.message();
+}
+
+struct Message {
+    std::uint32_t producer;
+    std::uint32_t seq;
+};
+
+int main() {
+    auto ph = fs::path("test.txt");
+    unsigned const producer_count = 4;
+    unsigned const consumer_count = 4;
+    std::uint32_t const message_count = 50000;
+
+    // Producers and consumers use separate mappings of the same file, as
+    // separate processes would.
+    MMapQueue<Message> tx, rx;
+    if (auto en = tx.create(ph, 256)) {
+        std::cout << "Queue create failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return -1;
+    }
+    if (auto en = rx.open(ph)) {
+        std::cout << "Queue open failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return -1;
+    }
+    assert(rx.capacity() == 256);
+    assert(rx.file().data() != tx.file().data());
+
+    std::atomic<std::uint64_t> received{0};
+    std::vector<std::atomic<std::uint64_t>> sums(producer_count);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < producer_count; ++t) {
+        workers.emplace_back([&tx, t, message_count] {
+            for (std::uint32_t i = 0; i < message_count; ++i) { tx.push(Message{t, i}); }
+        });
+    }
+    auto const total = std::uint64_t(producer_count) * message_count;
+    for (unsigned t = 0; t < consumer_count; ++t) {
+        workers.emplace_back([&] {
+            Message msg;
+            while (received.fetch_add(1) < total) {
+                rx.pop(msg);
+                sums[msg.producer] += msg.seq;
+            }
+        });
+    }
+    for (auto & w : workers) { w.join(); }
+
+    auto const expected = std::uint64_t(message_count) * (message_count - 1) / 2;
+    for (auto & s : sums) { assert(s == expected); }
+    assert(rx.empty());
+
+    Message msg;
+    bool ok = rx.tryPop(msg);
+    assert(!ok);
+    ok = tx.tryPush(Message{7, 42});
+    assert(ok);
+    ok = rx.tryPop(msg);
+    assert(ok && msg.producer == 7 && msg.seq == 42);
+
+    std::cout << "Transferred " << total << " messages through "
+        << tx.file().size() << " bytes of shared mapping" << std::endl;
+    tx.close();
+    rx.close();
+    fs::remove(ph);
+    return 0;
+}
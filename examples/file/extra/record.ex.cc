@@ -0,0 +1,111 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+// 40-byte fixed record: id, timestamp, price, quantity, flags, side, 6 reserved bytes
+constexpr std::size_t kRecordSize = 40;
+constexpr std::size_t kCount = 100000;
+
+struct Trade {
+    std::uint64_t id;
+    std::uint64_t ts;
+    double        price;
+    std::uint32_t qty;
+    std::uint32_t flags;
+    std::uint16_t side;
+};
+
+Trade makeTrade(std::size_t i) {
+    return Trade{i, 1700000000000ull + i, 100.0 + double(i % 100) / 4,
+        std::uint32_t(i % 1000), std::uint32_t(i & 0xff), std::uint16_t(i & 1)};
+}
+
+template <typename Fn>
+double elapsedMs(Fn && fn) {
+    auto const beg = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - beg).count();
+}
+
+void writeTrades() {
+    MMapFileStream mmfs;
+    auto en = mmfs.map("test.txt", AccessFlag::kDefault, kRecordSize * kCount);
+    assert(!en);
+    auto t = elapsedMs([&] {
+        for (std::size_t i = 0; i < kCount; ++i) {
+            auto rec = mmfs.record(kRecordSize);
+            assert(rec);
+            auto tr = makeTrade(i);
+            rec << tr.id << tr.ts << tr.price << tr.qty << tr.flags << tr.side;
+            rec.skip(6);
+        }
+    });
+    std::cout << "record writes: " << t << " ms" << std::endl;
+    // no room for another record
+    auto rec = mmfs.record(kRecordSize);
+    assert(!rec);
+    assert(mmfs.status() == MMapFileStream::Status::kWriteFailed);
+}
+
+void readTrades() {
+    MMapFileStream mmfs;
+    auto en = mmfs.map("test.txt", AccessFlag::kReadOnly);
+    assert(!en);
+
+    std::uint64_t qty_sum = 0;
+    auto t = elapsedMs([&] {
+        for (std::size_t i = 0; i < kCount; ++i) {
+            auto rec = mmfs.readRecord(kRecordSize);
+            Trade tr;
+            rec >> tr.id >> tr.ts >> tr.price >> tr.qty >> tr.flags >> tr.side;
+            assert(tr.id == i && tr.side == (i & 1));
+            qty_sum += tr.qty;
+        }
+    });
+    std::cout << "record reads: " << t << " ms" << std::endl;
+
+    // fields can also be picked by offset without moving the cursor
+    mmfs.buffer().seek(kRecordSize * 7, BufferPos::kBeg);
+    auto rec = mmfs.readRecord(kRecordSize);
+    assert(rec.load<double>(16) == makeTrade(7).price);
+
+    mmfs.buffer().seek(0, BufferPos::kBeg);
+    std::uint64_t check_sum = 0;
+    t = elapsedMs([&] {
+        std::uint8_t reserved[6];
+        for (std::size_t i = 0; i < kCount; ++i) {
+            Trade tr;
+            mmfs >> tr.id >> tr.ts >> tr.price >> tr.qty >> tr.flags >> tr.side;
+            mmfs.read(reinterpret_cast<char *>(reserved), sizeof(reserved));
+            check_sum += tr.qty;
+        }
+    });
+    std::cout << "operator>> reads: " << t << " ms" << std::endl;
+    assert(mmfs.status() == MMapFileStream::Status::kOk && check_sum == qty_sum);
+}
+
+int main() {
+    writeTrades();
+    readTrades();
+    fs::remove("test.txt");
+    return 0;
+}
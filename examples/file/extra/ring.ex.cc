@@ -0,0 +1,93 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+std::string errMsg(errno_t en) {
+    return std::error_code{en, std::system_category()}.message();
+}
+
+// length-prefixed frame
+struct FrameHeader {
+    std::uint32_t length;
+};
+
+void ringWrap(MMapRing & ring) {
+    auto const cap = ring.capacity();
+    std::string tail(cap - 3, 'a');
+    auto n = ring.write(tail.data(), tail.size());
+    assert(n == tail.size());
+    n = ring.read(tail.data(), tail.size());
+    assert(n == tail.size());
+
+    // this record straddles the end of the storage
+    n = ring.write("0123456789", 10);
+    assert(n == 10);
+    auto * p = ring.peek(10);
+    assert(p && std::memcmp(p, "0123456789", 10) == 0);
+    ring.consume(10);
+    assert(ring.empty());
+}
+
+void ringFrames(MMapRing & ring) {
+    std::uint32_t const frame_count = 100000;
+    std::thread producer([&ring, frame_count] {
+        for (std::uint32_t i = 0; i < frame_count; ++i) {
+            auto payload = std::to_string(i);
+            FrameHeader hdr{std::uint32_t(payload.size())};
+            auto const length = sizeof(hdr) + payload.size();
+            char * p;
+            while (!(p = ring.prepare(length))) { std::this_thread::yield(); }
+            std::memcpy(p, &hdr, sizeof(hdr));
+            std::memcpy(p + sizeof(hdr), payload.data(), payload.size());
+            ring.commit(length);
+        }
+    });
+
+    // frames are parsed in place, never copied out of the ring
+    for (std::uint32_t i = 0; i < frame_count; ++i) {
+        char const * p;
+        while (!(p = ring.peek(sizeof(FrameHeader)))) { std::this_thread::yield(); }
+        FrameHeader hdr;
+        std::memcpy(&hdr, p, sizeof(hdr));
+        while (!(p = ring.peek(sizeof(hdr) + hdr.length))) { std::this_thread::yield(); }
+        assert(std::string_view(p + sizeof(hdr), hdr.length) == std::to_string(i));
+        ring.consume(sizeof(hdr) + hdr.length);
+    }
+    producer.join();
+    assert(ring.empty());
+}
+
+int main() {
+    MMapRing ring;
+    if (auto en = ring.create(4096)) {
+        std::cout << "Ring create failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return -1;
+    }
+    ringWrap(ring);
+    ringFrames(ring);
+    std::cout << "Ring capacity: " << ring.capacity() << std::endl;
+    return 0;
+}
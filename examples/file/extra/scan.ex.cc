@@ -0,0 +1,88 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+std::string errMsg(errno_t en) {
+    return std::error_code{en, std::system_category()}.message();
+}
+
+// per-key sums of a "key,value" csv
+using Totals = std::map<std::string, std::uint64_t>;
+
+int main() {
+    auto ph = fs::path("test.txt");
+    size_t const row_count = 500000;
+    std::uint64_t expected = 0;
+    {
+        std::ofstream ofs(ph, std::ios::binary);
+        for (size_t i = 0; i < row_count; ++i) {
+            ofs << "key" << i % 7 << ',' << i << '\n';
+            expected += i;
+        }
+    }
+
+    MMapFile mmfi;
+    if (auto en = mmfi.map(ph, AccessFlag::kReadOnly)) {
+        std::cout << "File map failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return -1;
+    }
+
+    ScanPolicy policy;
+    policy.chunk_size = size_t(64) << 10;
+    policy.threads = 4;
+    MMapScan scan(mmfi, policy);
+
+    // every chunk holds whole rows
+    for (size_t i = 0; i < scan.chunkCount(); ++i) {
+        assert(scan.chunk(i).back() == '\n');
+    }
+
+    auto totals = scan.mapReduce(Totals{},
+        [](Totals & acc, std::string_view chunk) {
+            for (auto line : detail::LineRange<char>(chunk, '\n')) {
+                auto const comma = line.find(',');
+                std::uint64_t val = 0;
+                std::from_chars(line.data() + comma + 1, line.data() + line.size() - 1, val);
+                acc[std::string(line.substr(0, comma))] += val;
+            }
+        },
+        [](Totals & into, Totals && from) {
+            for (auto & [key, val] : from) { into[key] += val; }
+        });
+
+    std::uint64_t sum = 0;
+    for (auto & [key, val] : totals) {
+        std::cout << key << ": " << val << std::endl;
+        sum += val;
+    }
+    std::cout << "Chunks: " << scan.chunkCount() << std::endl;
+    assert(totals.size() == 7 && sum == expected);
+
+    mmfi.unmap();
+    fs::remove(ph);
+    return 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+template <typename Fn>
+double elapsedMs(Fn && fn) {
+    auto const beg = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - beg).count();
+}
+
+int main() {
+    constexpr std::size_t kCount = std::size_t(1) << 20;
+    std::vector<std::uint32_t> ids(kCount);
+    std::vector<float> samples(kCount);
+    std::iota(ids.begin(), ids.end(), 0u);
+    for (std::size_t i = 0; i < kCount; ++i) { samples[i] = float(i) * 0.25f; }
+
+    {
+        // big-endian archive: ids then samples
+        MMapFileStream mmfs;
+        auto en = mmfs.map("test.txt", AccessFlag::kDefault, 2 * kCount * 4);
+        assert(!en);
+        std::size_t n_ids = 0, n_samples = 0;
+        auto t = elapsedMs([&] {
+            n_ids = mmfs.writeArray(std::span{ids});
+            n_samples = mmfs.writeArray(std::span{samples});
+        });
+        std::cout << "writeArray: " << t << " ms" << std::endl;
+        assert(n_ids == kCount && n_samples == kCount);
+        // no room left, nothing is written
+        n_ids = mmfs.writeArray(std::span{ids}.first(1));
+        assert(n_ids == 0);
+        assert(mmfs.status() == MMapFileStream::Status::kWriteFailed);
+    }
+    {
+        MMapFileStream mmfs;
+        auto en = mmfs.map("test.txt", AccessFlag::kReadOnly);
+        assert(!en);
+        std::vector<std::uint32_t> ids_in(kCount);
+        std::vector<float> samples_in(kCount);
+        std::size_t n_ids = 0, n_samples = 0;
+        auto t = elapsedMs([&] {
+            n_ids = mmfs.readArray(std::span{ids_in});
+            n_samples = mmfs.readArray(std::span{samples_in});
+        });
+        std::cout << "readArray: " << t << " ms" << std::endl;
+        assert(n_ids == kCount && n_samples == kCount);
+        assert(ids_in == ids && samples_in == samples);
+
+        mmfs.buffer().seek(0, BufferPos::kBeg);
+        t = elapsedMs([&] {
+            for (auto & i : ids_in) { mmfs >> i; }
+            for (auto & f : samples_in) { mmfs >> f; }
+        });
+        std::cout << "operator>>: " << t << " ms" << std::endl;
+        assert(ids_in == ids && samples_in == samples);
+    }
+    {
+        // the window buffer has no contiguous view, writes go through a staging block
+        MMapWindowStream mmws;
+        auto en = mmws.map("test.txt", AccessFlag::kReadWrite, WindowPolicy{.window_size = 1 << 16});
+        assert(!en);
+        mmws.buffer().seek(MMapWindowStream::off_type(kCount * 4), BufferPos::kBeg);
+        auto n = mmws.writeArray(std::span{samples});
+        assert(n == kCount);
+        mmws.buffer().seek(MMapWindowStream::off_type(kCount * 4), BufferPos::kBeg);
+        std::vector<float> samples_in(kCount);
+        n = mmws.readArray(std::span{samples_in});
+        assert(n == kCount);
+        assert(samples_in == samples);
+    }
+    fs::remove("test.txt");
+    return 0;
+}
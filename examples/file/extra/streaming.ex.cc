@@ -0,0 +1,77 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+int main() {
+    constexpr std::size_t kLines = 1 << 20;
+    {
+        MMapFileBuf buf;
+        buf.setGrowthPolicy(GrowthPolicy{.kind = GrowthKind::kGeometric});
+        auto en = buf.map("test.txt", AccessFlag::kDefault, 4096);
+        assert(!en);
+        buf.truncate(0);
+        for (std::size_t i = 0; i < kLines; ++i) {
+            auto line = std::to_string(i) + " the quick brown fox jumps over the lazy dog\n";
+            buf.write(line.data(), line.size());
+        }
+        en = buf.close();
+        assert(!en);
+    }
+
+    // one pass that should not evict the hot pages of other files
+    MMapFileBuf buf;
+    auto en = buf.map("test.txt", AccessFlag::kReadOnly);
+    assert(!en);
+    buf.setStreamingPolicy(StreamingPolicy{
+        .b_enabled = true, .read_ahead = 4 << 20, .keep_behind = 1 << 20, .step = 1 << 20});
+
+    std::size_t lines = 0, bytes = 0;
+    for (auto view = buf.readline(); !view.empty(); view = buf.readline()) {
+        ++lines;
+        bytes += view.size();
+    }
+    std::uint64_t minor = 0, major = 0;
+    MemMapTraits::pageFaults(minor, major);
+    std::cout << "lines: " << lines << ", bytes: " << bytes
+        << ", minor faults: " << minor << ", major faults: " << major << std::endl;
+    assert(lines == kLines && bytes == buf.size());
+
+    // seeking back re-reads the dropped pages transparently
+    buf.seek(0, BufferPos::kBeg);
+    auto first = buf.readline();
+    assert(first.substr(0, 2) == "0 ");
+    buf.close();
+
+    // private writes survive the scan moving past them
+    en = buf.map("test.txt", AccessFlag::kWriteCopy);
+    assert(!en);
+    buf.setStreamingPolicy(StreamingPolicy{
+        .b_enabled = true, .read_ahead = 1 << 20, .keep_behind = 0, .step = 1 << 16});
+    auto const written = buf.write("HELLO", 5);
+    assert(written == 5);
+    buf.flush();
+    while (!buf.readline().empty()) {}
+    assert(std::string_view(buf.file().data(), 5) == "HELLO");
+    buf.close();
+    fs::remove("test.txt");
+    return 0;
+}
@@ -0,0 +1,94 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+std::string errMsg(errno_t en) {
+    return std::error_code{en, std::system_category()}.message();
+}
+
+struct Point {
+    std::int32_t x;
+    std::int32_t y;
+};
+
+void anonVector() {
+    MMapVector<std::uint64_t> vec;
+    for (std::uint64_t i = 0; i < 1000000; ++i) {
+        auto en = vec.push_back(i);
+        assert(!en);
+    }
+    assert(vec.size() == 1000000 && vec.capacity() >= vec.size());
+    assert(std::accumulate(vec.begin(), vec.end(), std::uint64_t(0)) == 999999ull * 1000000 / 2);
+
+    vec.resize(10);
+    vec.shrinkToFit();
+    std::cout << "Anon vector: size " << vec.size() << ", capacity " << vec.capacity() << std::endl;
+}
+
+int fileVector(fs::path const & ph) {
+    {
+        MMapVector<Point> points;
+        if (auto en = points.open(ph)) {
+            std::cout << "Vector open failed: [" << en << "] "
+                << errMsg(en) << std::endl;
+            return -1;
+        }
+        // allocate the file blocks up front
+        if (auto en = points.reserve(100000)) {
+            std::cout << "Vector reserve failed: [" << en << "] "
+                << errMsg(en) << std::endl;
+            return -1;
+        }
+        for (std::int32_t i = 0; i < 100000; ++i) { points.emplace_back(Point{i, -i}); }
+    }
+    // trimmed to the elements on close
+    assert(fs::file_size(ph) == 100000 * sizeof(Point));
+
+    MMapVector<Point> points;
+    points.open(ph);
+    assert(points.size() == 100000);
+    assert(points.back().x == 99999 && points.back().y == -99999);
+    points.push_back(Point{1, 2});
+    std::cout << "File vector: size " << points.size() << std::endl;
+    points.close();
+
+    // copy-on-write growth moves to an anonymous mapping, the file is kept
+    auto const file_size = fs::file_size(ph);
+    MMapVector<Point> copy;
+    copy.open(ph, AccessFlag::kWriteCopy);
+    for (std::int32_t i = 0; i < 100000; ++i) { copy.emplace_back(Point{i, i}); }
+    assert(copy.size() == 200001 && !copy.isFileBacked());
+    assert(copy[99999].x == 99999 && copy[99999].y == -99999);
+    copy.close();
+    assert(fs::file_size(ph) == file_size);
+    return 0;
+}
+
+int main() {
+    auto ph = fs::path("test.txt");
+    fs::remove(ph);
+    anonVector();
+    if (fileVector(ph)) { return -1; }
+    fs::remove(ph);
+    return 0;
+}
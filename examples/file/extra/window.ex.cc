@@ -0,0 +1,100 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+std::string errMsg(errno_t en) {
+    return std::error_code{en, std::system_category()}.message();
+}
+
+size_t const kLineCount = 100000;
+
+void writeFile() {
+    MMapFileWindow mmfw;
+    {
+        MMapFile mmfi;
+        mmfi.map("test.txt", AccessFlag::kDefault, kLineCount * 10);
+    }
+
+    WindowPolicy policy;
+    policy.window_size = 1 << 16; // 64KB
+    if (auto en = mmfw.map("test.txt", AccessFlag::kWrite, policy)) {
+        std::cout << "Window map failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return;
+    }
+    assert(mmfw.windowSize() == policy.window_size);
+
+    for (size_t i = 0; i < kLineCount; ++i) {
+        auto s = std::to_string(i % 10000000);
+        s.resize(9, ' ');
+        s += '\n';
+        mmfw.writeView(s);
+    }
+    assert(mmfw.isEOF());
+    mmfw.flush();
+}
+
+void readFile() {
+    MMapFileWindow mmfw;
+    WindowPolicy policy;
+    policy.window_size = 1 << 16;
+    policy.read_ahead  = 1 << 18;
+    mmfw.map("test.txt", AccessFlag::kReadOnly, policy);
+
+    size_t lines = 0;
+    while (!mmfw.isEOF()) {
+        auto sv = mmfw.readline();
+        assert(sv.size() == 10 && sv.back() == '\n');
+        ++lines;
+    }
+    assert(mmfw.lastError() == kEnoOk);
+    std::cout << "Lines: " << lines << ", window offset: "
+        << mmfw.windowOffset() << std::endl;
+    assert(lines == kLineCount);
+
+    // jump back
+    mmfw.seek(10 * 42, BufferPos::kBeg);
+    std::cout << "Line 42: " << mmfw.readline();
+}
+
+void streamFile() {
+    MMapWindowStream mmws;
+    WindowPolicy policy;
+    policy.window_size = 1 << 12;
+    mmws.map("test.txt", AccessFlag::kReadOnly, policy);
+
+    // read across windows
+    std::uint64_t n = 0;
+    mmws.buffer().seek(4096 - 4, BufferPos::kBeg);
+    mmws >> n;
+    assert(mmws.status() == MMapWindowStream::Status::kOk);
+    std::cout << "Value across windows: " << std::hex << n << std::dec << std::endl;
+}
+
+int main() {
+    writeFile();
+    readFile();
+    streamFile();
+    fs::remove("test.txt");
+    return 0;
+}
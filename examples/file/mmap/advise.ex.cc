@@ -0,0 +1,64 @@
+/**
+ * Copyright 2024 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+std::string errMsg(errno_t en) {
+    return std::error_code{en, std::system_category()}.message();
+}
+
+void doAdvise(MMapFile & mmfi, char const * name, AdviceFlag flag) {
+    std::cout << name << ": ";
+    if (auto en = mmfi.advise(flag)) {
+        if (en == kEnoUnsupported) {
+            std::cout << "unsupported" << std::endl;
+        } else {
+            std::cout << "failed: [" << en << "] " << errMsg(en) << std::endl;
+        }
+        return;
+    }
+    std::cout << "ok" << std::endl;
+}
+
+int main() {
+    MMapFile mmfi;
+    // `kFree` and `kMergeable` need a private mapping
+    if (auto en = mmfi.anonMap(size_t(4) << 20, AccessFlag::kWriteCopy)) {
+        std::cout << "Anon map failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return -1;
+    }
+
+    doAdvise(mmfi, "Sequential", AdviceFlag::kSequential);
+    doAdvise(mmfi, "Populate write", AdviceFlag::kPopulateWrite);
+    doAdvise(mmfi, "Huge page", AdviceFlag::kHugePage);
+    doAdvise(mmfi, "Mergeable", AdviceFlag::kMergeable);
+    doAdvise(mmfi, "Unmergeable", AdviceFlag::kUnmergeable);
+    doAdvise(mmfi, "Cold", AdviceFlag::kCold);
+    doAdvise(mmfi, "Page out", AdviceFlag::kPageOut);
+
+    // recycle the buffer, pages are reclaimed lazily under memory pressure
+    mmfi[0] = 'a';
+    doAdvise(mmfi, "Free", AdviceFlag::kFree);
+
+    doAdvise(mmfi, "Dont need", AdviceFlag::kDontNeed);
+    assert(mmfi[0] == 0);
+    return 0;
+}
@@ -14,61 +14,74 @@
  * limitations under the License.
  */
 
+#include <cstring>
 #include <iostream>
-#include <unordered_map>
+#include <memory_resource>
+#include <thread>
+#include <vector>
 
 #include "aymmap/aymmap.hpp"
 
 using namespace aymmap;
 
-static std::unordered_map<char const *, MMapFile> s_mem_pool;
-
-char * myAlloc(size_t length) {
-    if (length == 0) [[unlikely]] {
-        return nullptr;
+void smallBlocks(MMapArena & arena) {
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&arena, t] {
+            std::vector<char *> blocks;
+            for (size_t i = 0; i < 10000; ++i) {
+                auto length = 16 + (i % 64) * 24;
+                auto * p = static_cast<char *>(arena.allocate(length));
+                assert(p);
+                std::memset(p, 'a' + t, length);
+                blocks.push_back(p);
+            }
+            for (size_t i = 0; i < blocks.size(); ++i) {
+                assert(blocks[i][0] == 'a' + t);
+                arena.deallocate(blocks[i], 16 + (i % 64) * 24);
+            }
+        });
     }
-    MMapFile mmfi;
-    mmfi.anonMap(length);
-    char * p_mem = mmfi.data();
-    assert(p_mem);
-    s_mem_pool.insert({p_mem, std::move(mmfi)});
-    return p_mem;
+    for (auto & w : workers) { w.join(); }
+
+    auto * p = arena.allocate(100, 64);
+    assert(reinterpret_cast<uintptr_t>(p) % 64 == 0);
+    arena.deallocate(p, 100, 64);
+    std::cout << "size class of 100: " << MMapArena::classSize(MMapArena::sizeClass(100)) << std::endl;
 }
 
-void myDealloc(char const * p_mem) {
-    s_mem_pool.erase(p_mem);
+void largeBlocks(MMapArena & arena) {
+    size_t const length = size_t(16) << 20; // 16MB
+    auto * p_mem = static_cast<char *>(arena.allocate(length));
+    assert(p_mem);
+    std::memset(p_mem, 'x', length);
+    arena.deallocate(p_mem, length);
+    std::cout << "pooled: " << arena.pooledBytes() << std::endl;
+
+    // the freed mapping is reused, no new mmap
+    auto * p_mem2 = static_cast<char *>(arena.allocate(length - 4096));
+    assert(p_mem2 == p_mem);
+    arena.deallocate(p_mem2, length - 4096);
+
+    arena.trim();
+    assert(arena.pooledBytes() == 0);
 }
 
-char * myRealloc(char const * p_mem, size_t length) {
-    if (s_mem_pool.find(p_mem) == s_mem_pool.end()) [[unlikely]] {
-        return nullptr;
+void pmrContainers(MMapArena & arena) {
+    MMapMemoryResource resource(arena);
+    std::pmr::vector<std::pmr::string> lines(&resource);
+    for (int i = 0; i < 1000; ++i) {
+        lines.emplace_back(std::string(100, char('0' + i % 10)));
     }
-    auto & mmfi = s_mem_pool[p_mem];
-    if (mmfi.resize(length)) {
-        myDealloc(p_mem);
-        return nullptr;
-    }
-    return mmfi.data();
+    lines.resize(10);
+    std::cout << "pmr line: " << lines[1].substr(0, 10) << std::endl;
 }
 
 int main() {
-    char * p_mem = myAlloc(10);
-
-    std::string text = "1234567890";
-    std::copy_n(text.c_str(), text.size(), p_mem);
-    p_mem[9] = 0;
-    std::cout << "alloc 10: " << p_mem << std::endl;
-
-    myRealloc(p_mem, 5);
-    p_mem[4] = 0;
-    std::cout << "alloc 5: " << p_mem << std::endl;
-
-    char * p_mem2 = myAlloc(1 << 30); // 1GB
-    
-    std::cout << "pool size: " << s_mem_pool.size() << std::endl;
-    myDealloc(p_mem);
-    myDealloc(p_mem2);
-    std::cout << "pool size: " << s_mem_pool.size() << std::endl;
+    MMapArena arena;
+    smallBlocks(arena);
+    largeBlocks(arena);
+    pmrContainers(arena);
+    std::cout << "mapped: " << arena.mappedBytes() << std::endl;
     return 0;
 }
-
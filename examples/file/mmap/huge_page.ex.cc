@@ -0,0 +1,60 @@
+/**
+ * Copyright 2024 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+std::string errMsg(errno_t en) {
+    return std::error_code{en, std::system_category()}.message();
+}
+
+void hugeMap(char const * name, AccessFlag flag) {
+    size_t length = size_t(8) << 20; // 8MB
+
+    MMapFile mmfi;
+    if (auto en = mmfi.anonMap(length, flag)) {
+        std::cout << name << " map failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return;
+    }
+    assert(mmfi.isMapped());
+    assert(mmfi.size() == length);
+
+    // touch every page
+    for (size_t i = 0; i < length; i += 4096) { mmfi[i] = 'a'; }
+
+    std::cout << name << " page size: " << mmfi.mappedPageSize()
+        << ", aligned: " << (reinterpret_cast<std::uintptr_t>(mmfi.data())
+            % MemMapTraits::hugePageSize(flag) == 0) << std::endl;
+}
+
+int main() {
+    std::cout << "Huge page size: "
+        << MemMapTraits::hugePageSize(AccessFlag::kHugeTLB) << std::endl;
+
+    hugeMap("Normal", AccessFlag::kDefault);
+    // fall back to normal pages when no huge page is reserved
+    hugeMap("HugeTLB 2MB", AccessFlag::kDefault | AccessFlag::kHugeTLB2MB);
+    hugeMap("HugeTLB 1GB", AccessFlag::kDefault | AccessFlag::kHugeTLB1GB);
+    hugeMap("Transparent", AccessFlag::kDefault | AccessFlag::kTransHuge | AccessFlag::kAlignHuge);
+    // try explicit huge pages first, then transparent huge pages
+    hugeMap("HugeTLB or transparent", AccessFlag::kDefault | AccessFlag::kHugeTLB
+        | AccessFlag::kTransHuge | AccessFlag::kAlignHuge);
+    return 0;
+}
@@ -0,0 +1,91 @@
+/**
+ * Copyright 2024 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+std::string errMsg(errno_t en) {
+    return std::error_code{en, std::system_category()}.message();
+}
+
+void printStats(char const * name, PrefaultStats const & stats) {
+    std::cout << name << ": " << stats.length << " bytes, "
+        << stats.threads << " threads, "
+        << stats.minor_faults << " minor faults, "
+        << stats.major_faults << " major faults, "
+        << std::chrono::duration_cast<std::chrono::microseconds>(stats.elapsed).count()
+        << " us" << std::endl;
+}
+
+int main() {
+    size_t length = size_t(64) << 20; // 64MB
+
+    {
+        // prefault when mapping
+        MMapFile mmfi;
+        if (auto en = mmfi.anonMap(length, AccessFlag::kDefault | AccessFlag::kPopulate)) {
+            std::cout << "Anon map failed: [" << en << "] "
+                << errMsg(en) << std::endl;
+            return -1;
+        }
+        PrefaultStats stats;
+        mmfi.prefault(true, 1, &stats);
+        printStats("Populated map", stats);
+    }
+
+    {
+        // prefault after mapping
+        MMapFile mmfi;
+        if (auto en = mmfi.anonMap(length)) {
+            std::cout << "Anon map failed: [" << en << "] "
+                << errMsg(en) << std::endl;
+            return -1;
+        }
+        PrefaultStats stats;
+        if (auto en = mmfi.prefault(true, 4, &stats)) {
+            std::cout << "Prefault failed: [" << en << "] "
+                << errMsg(en) << std::endl;
+            return -1;
+        }
+        printStats("Parallel prefault", stats);
+    }
+
+    {
+        auto ph = fs::path("test.txt");
+        MMapFile mmfi;
+        if (auto en = mmfi.map(ph, AccessFlag::kDefault, length)) {
+            std::cout << "File map failed: [" << en << "] "
+                << errMsg(en) << std::endl;
+            return -1;
+        }
+        mmfi.unmap();
+
+        mmfi.map(ph, AccessFlag::kReadOnly);
+        auto en = mmfi.prefault(true);
+        assert(en == kEnoInviArgs);
+
+        PrefaultStats stats;
+        mmfi.prefault(false, 2, &stats);
+        printStats("File prefault", stats);
+
+        mmfi.unmap();
+        fs::remove(ph);
+    }
+    return 0;
+}
@@ -0,0 +1,66 @@
+/**
+ * Copyright 2024 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+std::string errMsg(errno_t en) {
+    return std::error_code{en, std::system_category()}.message();
+}
+
+void check(char const * name, errno_t en) {
+    std::cout << name << ": ";
+    if (en) {
+        std::cout << "failed: [" << en << "] " << errMsg(en) << std::endl;
+    } else {
+        std::cout << "ok" << std::endl;
+    }
+}
+
+int main() {
+    auto ph = fs::path("test.txt");
+    size_t length = size_t(16) << 20; // 16MB
+    size_t page_size = size_t(MemMapTraits::pageSize());
+
+    MMapFile mmfi;
+    // unaligned offset, the mapping starts inside a page
+    if (auto en = mmfi.map(ph, AccessFlag::kDefault, length, 100)) {
+        std::cout << "File map failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return -1;
+    }
+
+    // pin the hot pages only, locked as they are touched
+    check("Lock on fault", mmfi.lock(page_size * 3 + 10, page_size, true));
+    mmfi[page_size * 3 + 10] = 'a';
+    check("Unlock", mmfi.unlock(page_size * 3 + 10, page_size));
+
+    check("Advise", mmfi.advise(AdviceFlag::kWillNeed, 1000, page_size * 4));
+    check("Sync", mmfi.sync(1000, 10));
+
+    check("Protect", mmfi.protect(AccessFlag::kReadOnly, page_size * 8, page_size));
+    check("Protect", mmfi.protect(AccessFlag::kWrite, page_size * 8, page_size));
+
+    auto en = mmfi.lock(length, 1);
+    assert(en == kEnoInviArgs);
+
+    mmfi.unmap();
+    fs::remove(ph);
+    return 0;
+}
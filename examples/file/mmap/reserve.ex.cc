@@ -0,0 +1,70 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+#include <string_view>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+std::string errMsg(errno_t en) {
+    return std::error_code{en, std::system_category()}.message();
+}
+
+int main() {
+    auto ph = fs::path("test.txt");
+
+    MMapFile mmfi;
+    // reserve 1GB of address space, only the mapped length is backed by the file
+    mmfi.reserve(size_t(1) << 30);
+    if (auto en = mmfi.map(ph, AccessFlag::kDefault, 10)) {
+        std::cout << "File map failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return -1;
+    }
+    std::copy_n("1234567890", 10, mmfi.data());
+
+    auto * const p_base = mmfi.data();
+    std::string_view head{mmfi.data(), 10};
+
+    for (size_t length = size_t(1) << 12; length <= (size_t(1) << 28); length <<= 4) {
+        if (auto en = mmfi.resize(length)) {
+            std::cout << "Resize failed: [" << en << "] "
+                << errMsg(en) << std::endl;
+            return -1;
+        }
+        // the base never moves, old views stay valid
+        assert(mmfi.data() == p_base);
+        mmfi[length - 1] = 'x';
+        std::cout << "Size: " << mmfi.size() << ", head: " << head << std::endl;
+    }
+
+    mmfi.resize(5);
+    assert(mmfi.data() == p_base);
+    std::cout << "Size after shrink: " << mmfi.size()
+        << ", file size: " << fs::file_size(ph) << std::endl;
+
+    // beyond the reservation
+    auto en = mmfi.resize(size_t(2) << 30);
+    assert(en != kEnoOk);
+    assert(mmfi.data() == p_base);
+    assert(fs::file_size(ph) == 5);
+
+    mmfi.unmap();
+    fs::remove(ph);
+    return 0;
+}
@@ -0,0 +1,98 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <iostream>
+#include <string_view>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+std::string errMsg(errno_t en) {
+    return std::error_code{en, std::system_category()}.message();
+}
+
+int namedSegment() {
+    char const * name = "/aymmap-example";
+
+    MMapFile writer;
+    if (auto en = writer.shmMap(name, AccessFlag::kDefault, 4096)) {
+        std::cout << "Shared memory create failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return -1;
+    }
+    std::memcpy(writer.data(), "shared state", 12);
+
+    // another process would attach by name
+    MMapFile reader;
+    auto en = reader.shmMap(name, AccessFlag::kReadOnly);
+    assert(!en && reader.size() == 4096);
+    std::cout << "Segment: " << std::string_view(reader.data(), 12) << std::endl;
+
+    en = MMapFile::shmUnlink(name);
+    assert(!en);
+    return 0;
+}
+
+int sealedMemFile() {
+    MMapFile writer;
+    if (auto en = writer.memMap(4096)) {
+        std::cout << "Memory file create failed: [" << en << "] "
+            << errMsg(en) << std::endl;
+        return -1;
+    }
+    std::memcpy(writer.data(), "immutable", 9);
+
+    // freeze the content, then readers can map it without defensive copies
+    auto en = writer.seal(SealFlag::kResize | SealFlag::kFutureWrite | SealFlag::kSeal);
+    if (en) {
+        std::cout << "Seal failed: [" << en << "] " << errMsg(en) << std::endl;
+        return -1;
+    }
+    SealFlag seals{};
+    en = writer.seals(seals);
+    assert(!en && (seals & SealFlag::kResize) == SealFlag::kResize);
+
+    MMapFile reader;
+    en = reader.fileMap(writer.fileHandle(), AccessFlag::kReadOnly);
+    assert(!en);
+    std::cout << "Sealed: " << std::string_view(reader.data(), 9) << std::endl;
+
+    MMapFile intruder;
+    en = intruder.fileMap(writer.fileHandle(), AccessFlag::kReadWrite);
+    std::cout << "Writable map of a sealed file: [" << en << "] " << errMsg(en) << std::endl;
+    assert(en);
+    en = writer.resize(8192);
+    assert(en);
+    return 0;
+}
+
+void hugeMemFile() {
+    MMapFile mmfi;
+    // falls back to normal pages if no huge pages are reserved
+    auto en = mmfi.memMap(size_t(1) << 21, AccessFlag::kDefault | AccessFlag::kHugeTLB);
+    assert(!en);
+    mmfi[mmfi.size() - 1] = 'x';
+    std::cout << "Memory file page size: " << mmfi.mappedPageSize() << std::endl;
+}
+
+int main() {
+    if (namedSegment()) { return -1; }
+    if (sealedMemFile()) { return -1; }
+    hugeMemFile();
+    return 0;
+}
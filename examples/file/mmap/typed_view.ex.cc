@@ -0,0 +1,74 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+// On-disk record with a fixed big-endian layout, independent of the host.
+struct Record {
+    be_u32 id;
+    be_f64 value;
+    le_u16 flags;
+};
+static_assert(sizeof(Record) == 14 && alignof(Record) == 1);
+
+int main() {
+    std::filesystem::path ph = "test.txt";
+    {
+        MMapFile fi;
+        auto en = fi.map(ph, AccessFlag::kDefault, 4096);
+        assert(!en);
+
+        // header: record count, then a packed record array
+        auto header = fi.view<be_u32>(0, 1);
+        assert(header.size() == 1);
+        header[0] = 3;
+        auto records = fi.view<Record>(4, 3);
+        assert(records.size() == 3);
+        for (std::uint32_t i = 0; i < records.size(); ++i) {
+            records[i].id    = i + 1;
+            records[i].value = 0.5 * (i + 1);
+            records[i].flags = std::uint16_t(1) << i;
+        }
+        // native scalars need natural alignment
+        assert(fi.view<std::uint64_t>(8, 4).size() == 4);
+        assert(fi.view<std::uint64_t>(4, 1).empty());
+        // out of bounds
+        assert(fi.view<std::uint64_t>(0, 4096).empty());
+        assert(fi.view<std::uint64_t>(0).size() == 512);
+    }
+    {
+        MMapFileBuf fb;
+        auto en = fb.map(ph, AccessFlag::kReadOnly);
+        assert(!en);
+        auto count = fb.readSpan<be_u32>(1);
+        assert(count.size() == 1);
+        auto records = fb.readSpan<Record>(count[0]);
+        assert(records.size() == 3);
+        auto sum = std::accumulate(records.begin(), records.end(), 0.0,
+            [](double acc, Record const & r) { return acc + r.value; });
+        std::cout << "Records: " << records.size() << ", id[2] = " << records[2].id
+            << ", flags[2] = " << records[2].flags << ", sum = " << sum << std::endl;
+        assert(records[2].id == 3 && records[2].flags == 4 && sum == 3.0);
+        assert(fb.tell() == 4 + 3 * sizeof(Record));
+    }
+    std::filesystem::remove(ph);
+    return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "aymmap/detail/endian.hpp"
+#include "aymmap/detail/simd.hpp"
+
+namespace aymmap::detail {
+template <typename U>
+inline void _byteswapScalar(unsigned char * dst, unsigned char const * src, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+        U u;
+        std::memcpy(&u, src + i * sizeof(U), sizeof(U));
+        u = byteswap(u);
+        std::memcpy(dst + i * sizeof(U), &u, sizeof(U));
+    }
+}
+
+inline void _byteswapScalar(unsigned char * dst, unsigned char const * src,
+    std::size_t n, std::size_t width) noexcept {
+    switch (width) {
+    case 2: _byteswapScalar<std::uint16_t>(dst, src, n); break;
+    case 4: _byteswapScalar<std::uint32_t>(dst, src, n); break;
+    case 8: _byteswapScalar<std::uint64_t>(dst, src, n); break;
+    default: std::memcpy(dst, src, n * width); break;
+    }
+}
+
+#ifdef _AYMMAP_SIMD_X86
+// `pshufb` control reversing every `width`-byte lane of a 16-byte block.
+inline __m128i _byteswapMask(std::size_t width) noexcept {
+    alignas(16) unsigned char idx[16];
+    for (unsigned i = 0; i < 16; ++i) {
+        idx[i] = static_cast<unsigned char>(i - i % width + (width - 1 - i % width));
+    }
+    return _mm_load_si128(reinterpret_cast<__m128i const *>(idx));
+}
+
+_AYMMAP_TARGET_SSSE3
+inline std::size_t _byteswapSSSE3(unsigned char * dst, unsigned char const * src,
+    std::size_t bytes, std::size_t width) noexcept {
+    auto const mask = _byteswapMask(width);
+    std::size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_shuffle_epi8(v, mask));
+    }
+    return i;
+}
+
+_AYMMAP_TARGET_AVX2
+inline std::size_t _byteswapAVX2(unsigned char * dst, unsigned char const * src,
+    std::size_t bytes, std::size_t width) noexcept {
+    // the shuffle works within 128-bit lanes, so both lanes take the same control
+    auto const mask = _mm256_broadcastsi128_si256(_byteswapMask(width));
+    std::size_t i = 0;
+    for (; i + 64 <= bytes; i += 64) {
+        auto const a = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(src + i));
+        auto const b = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(src + i + 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_shuffle_epi8(a, mask));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i + 32), _mm256_shuffle_epi8(b, mask));
+    }
+    for (; i + 32 <= bytes; i += 32) {
+        auto const a = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_shuffle_epi8(a, mask));
+    }
+    return i;
+}
+#endif
+
+/**
+ * Copy `n` elements of `width` bytes from `src` to `dst`, reversing the
+ * bytes of each. `dst` may equal `src`. Vectorized with AVX2 or SSSE3
+ * where available.
+ */
+inline void byteswapCopy(void * dst, void const * src, std::size_t n, std::size_t width) noexcept {
+    auto * d = static_cast<unsigned char *>(dst);
+    auto const * s = static_cast<unsigned char const *>(src);
+    std::size_t done = 0;
+#ifdef _AYMMAP_SIMD_X86
+    if (width == 2 || width == 4 || width == 8) {
+        if (_hasAVX2()) {
+            done = _byteswapAVX2(d, s, n * width, width);
+        } else if (_hasSSSE3()) {
+            done = _byteswapSSSE3(d, s, n * width, width);
+        }
+    }
+#endif
+    _byteswapScalar(d + done, s + done, n - done / width, width);
+}
+
+/**
+ * Copy `n` values of `T` between host order and `_endian` order, a plain
+ * `memcpy` when no conversion is needed. `dst` may equal `src`.
+ */
+template <Endian _endian, typename T>
+inline void fitEndianCopy(void * dst, void const * src, std::size_t n) noexcept {
+    if constexpr (_endian == Endian::native || sizeof(T) == 1) {
+        if (dst != src) { std::memcpy(dst, src, n * sizeof(T)); }
+    } else {
+        byteswapCopy(dst, src, n, sizeof(T));
+    }
+}
+}
@@ -0,0 +1,185 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "aymmap/detail/endian.hpp"
+#include "aymmap/detail/simd.hpp"
+
+namespace aymmap::detail {
+template <std::integral T>
+constexpr std::make_unsigned_t<T> zigzagEncode(T n) noexcept {
+    using U = std::make_unsigned_t<T>;
+    if constexpr (std::is_signed_v<T>) {
+        return (U(n) << 1) ^ U(n >> (sizeof(T) * 8 - 1));
+    } else {
+        return n;
+    }
+}
+
+template <std::integral T>
+constexpr T zigzagDecode(std::make_unsigned_t<T> u) noexcept {
+    if constexpr (std::is_signed_v<T>) {
+        return T((u >> 1) ^ (~(u & 1) + 1));
+    } else {
+        return u;
+    }
+}
+
+inline constexpr std::size_t kMaxVarintSize = 10;
+
+// LEB128, return the bytes written to `out` (at most `kMaxVarintSize`).
+inline std::size_t encodeVarint(std::uint64_t n, unsigned char * out) noexcept {
+    std::size_t i = 0;
+    while (n >= 0x80) {
+        out[i++] = static_cast<unsigned char>(n | 0x80);
+        n >>= 7;
+    }
+    out[i++] = static_cast<unsigned char>(n);
+    return i;
+}
+
+// Return the bytes consumed, 0 if `[p, end)` holds no complete varint.
+inline std::size_t decodeVarint(unsigned char const * p, unsigned char const * end,
+    std::uint64_t & n) noexcept {
+    std::uint64_t val = 0;
+    for (std::size_t i = 0; i < kMaxVarintSize && p + i < end; ++i) {
+        val |= std::uint64_t(p[i] & 0x7f) << (7 * i);
+        if (!(p[i] & 0x80)) {
+            n = val;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Frame-of-reference bit packing of 128 32-bit deltas.
+ *
+ * Values are interleaved over four 32-bit lanes (value `i` in lane `i % 4`)
+ * and each lane is packed as a little-endian bit stream, so a block of
+ * width `w` takes `w` 16-byte words and one SSE2 shift/mask decodes four
+ * values at a time.
+ */
+inline constexpr std::size_t kPackBlock = 128;
+
+inline constexpr std::size_t packedBlockSize(unsigned width) noexcept { return 16 * width; }
+
+inline unsigned packWidth(std::uint32_t const * deltas) noexcept {
+    std::uint32_t acc = 0;
+    for (std::size_t i = 0; i < kPackBlock; ++i) { acc |= deltas[i]; }
+    return unsigned(std::bit_width(acc));
+}
+
+inline void packBlock(std::uint32_t const * deltas, unsigned width, unsigned char * out) noexcept {
+    if (width == 0) { return; }
+    std::uint32_t acc[4] = {};
+    unsigned shift = 0;
+    auto store = [&out](std::uint32_t const (&words)[4]) {
+        for (auto w : words) {
+            w = autoFitEndian<Endian::little>(w);
+            std::memcpy(out, &w, 4);
+            out += 4;
+        }
+    };
+    for (std::size_t j = 0; j < kPackBlock / 4; ++j) {
+        for (unsigned k = 0; k < 4; ++k) { acc[k] |= deltas[4 * j + k] << shift; }
+        shift += width;
+        if (shift >= 32) {
+            store(acc);
+            shift -= 32;
+            for (unsigned k = 0; k < 4; ++k) {
+                acc[k] = shift ? deltas[4 * j + k] >> (width - shift) : 0;
+            }
+        }
+    }
+}
+
+inline void _unpackBlockScalar(unsigned char const * in, unsigned width,
+    std::uint32_t base, std::uint32_t * out) noexcept {
+    auto const mask = width == 32 ? ~std::uint32_t(0) : (std::uint32_t(1) << width) - 1;
+    std::uint32_t cur[4];
+    auto load = [&in](std::uint32_t (&words)[4]) {
+        for (auto & w : words) {
+            std::memcpy(&w, in, 4);
+            w = autoFitEndian<Endian::little>(w);
+            in += 4;
+        }
+    };
+    load(cur);
+    unsigned shift = 0;
+    for (std::size_t j = 0; j < kPackBlock / 4; ++j) {
+        std::uint32_t val[4];
+        for (unsigned k = 0; k < 4; ++k) { val[k] = cur[k] >> shift; }
+        shift += width;
+        if (shift >= 32 && j + 1 < kPackBlock / 4) {
+            shift -= 32;
+            load(cur);
+            if (shift) {
+                for (unsigned k = 0; k < 4; ++k) { val[k] |= cur[k] << (width - shift); }
+            }
+        }
+        for (unsigned k = 0; k < 4; ++k) { out[4 * j + k] = (val[k] & mask) + base; }
+    }
+}
+
+#ifdef _AYMMAP_SIMD_X86
+inline void _unpackBlockSSE2(unsigned char const * in, unsigned width,
+    std::uint32_t base, std::uint32_t * out) noexcept {
+    auto const * p_in = reinterpret_cast<__m128i const *>(in);
+    auto const mask = _mm_set1_epi32(int(width == 32 ? ~std::uint32_t(0) : (std::uint32_t(1) << width) - 1));
+    auto const v_base = _mm_set1_epi32(int(base));
+    auto cur = _mm_loadu_si128(p_in++);
+    unsigned shift = 0;
+    for (std::size_t j = 0; j < kPackBlock / 4; ++j) {
+        auto val = _mm_srl_epi32(cur, _mm_cvtsi32_si128(int(shift)));
+        shift += width;
+        if (shift >= 32 && j + 1 < kPackBlock / 4) {
+            shift -= 32;
+            cur = _mm_loadu_si128(p_in++);
+            if (shift) { val = _mm_or_si128(val, _mm_sll_epi32(cur, _mm_cvtsi32_si128(int(width - shift)))); }
+        }
+        val = _mm_add_epi32(_mm_and_si128(val, mask), v_base);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4 * j), val);
+    }
+}
+#endif
+
+/**
+ * Decode a block written by `packBlock` and add `base` to every value.
+ * Reads `packedBlockSize(width)` bytes from `in`.
+ */
+inline void unpackBlock(unsigned char const * in, unsigned width,
+    std::uint32_t base, std::uint32_t * out) noexcept {
+    if (width == 0) {
+        for (std::size_t i = 0; i < kPackBlock; ++i) { out[i] = base; }
+        return;
+    }
+#if defined(_AYMMAP_SIMD_X86)
+    if constexpr (Endian::native == Endian::little) {
+        _unpackBlockSSE2(in, width, base, out);
+        return;
+    }
+#endif
+    _unpackBlockScalar(in, width, base, out);
+}
+}
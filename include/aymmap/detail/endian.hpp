@@ -19,6 +19,7 @@
 #include <type_traits>
 #include <concepts>
 #include <bit>
+#include <cstring>
 
 namespace aymmap {
 using Endian = std::endian;
@@ -66,5 +67,65 @@ inline constexpr T autoFitEndian(T n) noexcept {
         return detail::byteswap(n);
     }
 }
-}
 
+/**
+ * Scalar stored in `_endian` byte order. It has no alignment requirement,
+ * so typed views can point it at foreign-endian data anywhere in a mapping;
+ * the value is converted on every load and store.
+ */
+template <Endian _endian, typename T>
+requires std::integral<T> || std::floating_point<T>
+class EndianScalar {
+public:
+    using value_type = T;
+
+    EndianScalar() noexcept = default;
+    EndianScalar(value_type val) noexcept { store(val); }
+
+    EndianScalar & operator=(value_type val) noexcept {
+        store(val);
+        return *this;
+    }
+
+    value_type load() const noexcept {
+        value_type val;
+        std::memcpy(&val, m_bytes, sizeof(val));
+        return autoFitEndian<_endian>(val);
+    }
+
+    void store(value_type val) noexcept {
+        val = autoFitEndian<_endian>(val);
+        std::memcpy(m_bytes, &val, sizeof(val));
+    }
+
+    operator value_type() const noexcept { return load(); }
+
+private:
+    unsigned char m_bytes[sizeof(value_type)];
+};
+
+template <typename T> using BigEndian    = EndianScalar<Endian::big, T>;
+template <typename T> using LittleEndian = EndianScalar<Endian::little, T>;
+
+using be_i8  = BigEndian<std::int8_t>;
+using be_i16 = BigEndian<std::int16_t>;
+using be_i32 = BigEndian<std::int32_t>;
+using be_i64 = BigEndian<std::int64_t>;
+using be_u8  = BigEndian<std::uint8_t>;
+using be_u16 = BigEndian<std::uint16_t>;
+using be_u32 = BigEndian<std::uint32_t>;
+using be_u64 = BigEndian<std::uint64_t>;
+using be_f32 = BigEndian<float>;
+using be_f64 = BigEndian<double>;
+
+using le_i8  = LittleEndian<std::int8_t>;
+using le_i16 = LittleEndian<std::int16_t>;
+using le_i32 = LittleEndian<std::int32_t>;
+using le_i64 = LittleEndian<std::int64_t>;
+using le_u8  = LittleEndian<std::uint8_t>;
+using le_u16 = LittleEndian<std::uint16_t>;
+using le_u32 = LittleEndian<std::uint32_t>;
+using le_u64 = LittleEndian<std::uint64_t>;
+using le_f32 = LittleEndian<float>;
+using le_f64 = LittleEndian<double>;
+}
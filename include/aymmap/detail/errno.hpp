@@ -23,5 +23,8 @@ constexpr errno_t kEnoUnimpl = errno_t(-1);
 constexpr errno_t kEnoInviArgs = errno_t(-2);
 constexpr errno_t kEnoUnmapped = errno_t(-3);
 constexpr errno_t kEnoMapIsAnon = errno_t(-4);
+constexpr errno_t kEnoUnsupported = errno_t(-5);
+constexpr errno_t kEnoStale = errno_t(-6);
+constexpr errno_t kEnoNotReady = errno_t(-7);
 }
 
@@ -0,0 +1,111 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <iterator>
+#include <map>
+#include <utility>
+
+namespace aymmap::detail {
+/**
+ * Set of disjoint half-open intervals, overlapping and adjacent intervals
+ * are merged on insertion. The last touched interval is cached so that
+ * sequential insertions do not search the tree.
+ */
+template <std::unsigned_integral T>
+class IntervalSet {
+public:
+    using value_type     = T;
+    using map_type       = std::map<value_type, value_type>;
+    using const_iterator = typename map_type::const_iterator;
+
+    IntervalSet() = default;
+    ~IntervalSet() = default;
+    IntervalSet(IntervalSet const & ot) : m_map(ot.m_map), m_length(ot.m_length) {}
+    IntervalSet(IntervalSet && ot) noexcept : m_map(std::move(ot.m_map)), m_length(ot.m_length) { ot.clear(); }
+    IntervalSet & operator=(IntervalSet const & ot) {
+        m_map    = ot.m_map;
+        m_last   = m_map.end();
+        m_length = ot.m_length;
+        return *this;
+    }
+    IntervalSet & operator=(IntervalSet && ot) noexcept {
+        m_map    = std::move(ot.m_map);
+        m_last   = m_map.end();
+        m_length = ot.m_length;
+        ot.clear();
+        return *this;
+    }
+
+    bool empty() const noexcept { return m_map.empty(); }
+    std::size_t size() const noexcept { return m_map.size(); }
+    // Total length covered by the intervals.
+    value_type length() const noexcept { return m_length; }
+    const_iterator begin() const noexcept { return m_map.begin(); }
+    const_iterator end() const noexcept { return m_map.end(); }
+
+    void clear() noexcept {
+        m_map.clear();
+        m_last   = m_map.end();
+        m_length = 0;
+    }
+
+    void add(value_type beg, value_type end) {
+        if (beg >= end) [[unlikely]] { return; }
+
+        // fast path: inside or extending the last touched interval
+        if (m_last != m_map.end() && beg >= m_last->first && beg <= m_last->second) {
+            if (end <= m_last->second) { return; }
+            auto next = std::next(m_last);
+            if (next == m_map.end() || next->first > end) {
+                m_length += end - m_last->second;
+                m_last->second = end;
+                return;
+            }
+        }
+
+        auto iter = m_map.upper_bound(beg);
+        if (iter != m_map.begin()) {
+            auto prev = std::prev(iter);
+            if (prev->second >= beg) {
+                beg  = prev->first;
+                end  = std::max(end, prev->second);
+                iter = prev;
+            }
+        }
+        while (iter != m_map.end() && iter->first <= end) {
+            end  = std::max(end, iter->second);
+            m_length -= iter->second - iter->first;
+            iter = m_map.erase(iter);
+        }
+        m_last = m_map.emplace_hint(iter, beg, end);
+        m_length += end - beg;
+    }
+
+    const_iterator erase(const_iterator iter) {
+        m_last = m_map.end();
+        m_length -= iter->second - iter->first;
+        return m_map.erase(iter);
+    }
+
+private:
+    map_type m_map;
+    typename map_type::iterator m_last = m_map.end();
+    value_type m_length = 0;
+};
+}
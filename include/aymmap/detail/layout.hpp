@@ -0,0 +1,177 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+
+#include "aymmap/detail/endian.hpp"
+
+namespace aymmap {
+/**
+ * Serialized layout of a struct, specialize it with the members to write
+ * in order:
+ *
+ *     template <> struct aymmap::StreamLayout<Point> {
+ *         static constexpr auto fields = std::tuple{&Point::x, &Point::y};
+ *     };
+ *
+ * or use `AYMMAP_STREAM_LAYOUT(Point, x, y)` at global scope. Members may be
+ * arithmetic, enums, described structs, or arrays of those. The serialized
+ * form is the fields back to back in the stream endian, without padding.
+ */
+template <typename T>
+struct StreamLayout;
+
+template <typename T>
+concept StreamDescribed = requires { StreamLayout<T>::fields; };
+
+#define AYMMAP_STREAM_LAYOUT(type, ...) \
+    template <> struct aymmap::StreamLayout<type> { \
+        using _Self = type; \
+        static constexpr auto fields = ::aymmap::detail::_memberTuple<_Self>(_AYMMAP_LAYOUT_PTRS(__VA_ARGS__)); \
+    };
+
+namespace detail {
+template <typename T, typename... Ms>
+constexpr auto _memberTuple(Ms T::*... ptrs) noexcept { return std::tuple{ptrs...}; }
+
+#define _AYMMAP_LAYOUT_PTR(m) &_Self::m
+#define _AYMMAP_LAYOUT_EXPAND(x) x
+#define _AYMMAP_LAYOUT_PTRS_1(a) _AYMMAP_LAYOUT_PTR(a)
+#define _AYMMAP_LAYOUT_PTRS_2(a, ...) _AYMMAP_LAYOUT_PTR(a), _AYMMAP_LAYOUT_EXPAND(_AYMMAP_LAYOUT_PTRS_1(__VA_ARGS__))
+#define _AYMMAP_LAYOUT_PTRS_3(a, ...) _AYMMAP_LAYOUT_PTR(a), _AYMMAP_LAYOUT_EXPAND(_AYMMAP_LAYOUT_PTRS_2(__VA_ARGS__))
+#define _AYMMAP_LAYOUT_PTRS_4(a, ...) _AYMMAP_LAYOUT_PTR(a), _AYMMAP_LAYOUT_EXPAND(_AYMMAP_LAYOUT_PTRS_3(__VA_ARGS__))
+#define _AYMMAP_LAYOUT_PTRS_5(a, ...) _AYMMAP_LAYOUT_PTR(a), _AYMMAP_LAYOUT_EXPAND(_AYMMAP_LAYOUT_PTRS_4(__VA_ARGS__))
+#define _AYMMAP_LAYOUT_PTRS_6(a, ...) _AYMMAP_LAYOUT_PTR(a), _AYMMAP_LAYOUT_EXPAND(_AYMMAP_LAYOUT_PTRS_5(__VA_ARGS__))
+#define _AYMMAP_LAYOUT_PTRS_7(a, ...) _AYMMAP_LAYOUT_PTR(a), _AYMMAP_LAYOUT_EXPAND(_AYMMAP_LAYOUT_PTRS_6(__VA_ARGS__))
+#define _AYMMAP_LAYOUT_PTRS_8(a, ...) _AYMMAP_LAYOUT_PTR(a), _AYMMAP_LAYOUT_EXPAND(_AYMMAP_LAYOUT_PTRS_7(__VA_ARGS__))
+#define _AYMMAP_LAYOUT_PTRS_9(a, ...) _AYMMAP_LAYOUT_PTR(a), _AYMMAP_LAYOUT_EXPAND(_AYMMAP_LAYOUT_PTRS_8(__VA_ARGS__))
+#define _AYMMAP_LAYOUT_PTRS_10(a, ...) _AYMMAP_LAYOUT_PTR(a), _AYMMAP_LAYOUT_EXPAND(_AYMMAP_LAYOUT_PTRS_9(__VA_ARGS__))
+#define _AYMMAP_LAYOUT_PTRS_11(a, ...) _AYMMAP_LAYOUT_PTR(a), _AYMMAP_LAYOUT_EXPAND(_AYMMAP_LAYOUT_PTRS_10(__VA_ARGS__))
+#define _AYMMAP_LAYOUT_PTRS_12(a, ...) _AYMMAP_LAYOUT_PTR(a), _AYMMAP_LAYOUT_EXPAND(_AYMMAP_LAYOUT_PTRS_11(__VA_ARGS__))
+#define _AYMMAP_LAYOUT_PTRS_13(a, ...) _AYMMAP_LAYOUT_PTR(a), _AYMMAP_LAYOUT_EXPAND(_AYMMAP_LAYOUT_PTRS_12(__VA_ARGS__))
+#define _AYMMAP_LAYOUT_PTRS_14(a, ...) _AYMMAP_LAYOUT_PTR(a), _AYMMAP_LAYOUT_EXPAND(_AYMMAP_LAYOUT_PTRS_13(__VA_ARGS__))
+#define _AYMMAP_LAYOUT_PTRS_15(a, ...) _AYMMAP_LAYOUT_PTR(a), _AYMMAP_LAYOUT_EXPAND(_AYMMAP_LAYOUT_PTRS_14(__VA_ARGS__))
+#define _AYMMAP_LAYOUT_PTRS_16(a, ...) _AYMMAP_LAYOUT_PTR(a), _AYMMAP_LAYOUT_EXPAND(_AYMMAP_LAYOUT_PTRS_15(__VA_ARGS__))
+#define _AYMMAP_LAYOUT_COUNT(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, n, ...) n
+#define _AYMMAP_LAYOUT_CAT(a, b) a##b
+#define _AYMMAP_LAYOUT_SELECT(n) _AYMMAP_LAYOUT_CAT(_AYMMAP_LAYOUT_PTRS_, n)
+#define _AYMMAP_LAYOUT_PTRS(...) _AYMMAP_LAYOUT_EXPAND(_AYMMAP_LAYOUT_SELECT(_AYMMAP_LAYOUT_EXPAND( \
+    _AYMMAP_LAYOUT_COUNT(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1)))(__VA_ARGS__))
+
+template <typename T> struct _IsStdArray : std::false_type {};
+template <typename T, std::size_t N> struct _IsStdArray<std::array<T, N>> : std::true_type {};
+
+template <typename M> struct _MemberOf;
+template <typename C, typename M> struct _MemberOf<M C::*> { using type = M; };
+template <typename P> using _member_t = typename _MemberOf<std::remove_cvref_t<P>>::type;
+
+template <typename F>
+constexpr std::size_t fieldSize() noexcept {
+    if constexpr (std::is_arithmetic_v<F> || std::is_enum_v<F>) {
+        return sizeof(F);
+    } else if constexpr (std::is_array_v<F>) {
+        return std::extent_v<F> * fieldSize<std::remove_extent_t<F>>();
+    } else if constexpr (_IsStdArray<F>::value) {
+        return std::tuple_size_v<F> * fieldSize<typename F::value_type>();
+    } else {
+        static_assert(StreamDescribed<F>, "field type has no StreamLayout");
+        return std::apply([](auto... ptrs) {
+            return (std::size_t(0) + ... + fieldSize<_member_t<decltype(ptrs)>>());
+        }, StreamLayout<F>::fields);
+    }
+}
+
+// Serialized size of a described struct.
+template <StreamDescribed T>
+inline constexpr std::size_t kStreamSize = fieldSize<T>();
+
+template <Endian _endian, typename F>
+void encodeField(F const & f, unsigned char *& out) noexcept {
+    if constexpr (std::is_enum_v<F>) {
+        encodeField<_endian>(static_cast<std::underlying_type_t<F>>(f), out);
+    } else if constexpr (std::is_arithmetic_v<F>) {
+        auto const n = autoFitEndian<_endian>(f);
+        std::memcpy(out, &n, sizeof(F));
+        out += sizeof(F);
+    } else if constexpr (std::is_array_v<F> || _IsStdArray<F>::value) {
+        for (auto const & e : f) { encodeField<_endian>(e, out); }
+    } else {
+        std::apply([&](auto... ptrs) { (encodeField<_endian>(f.*ptrs, out), ...); },
+            StreamLayout<F>::fields);
+    }
+}
+
+template <Endian _endian, typename F>
+void decodeField(unsigned char const *& in, F & f) noexcept {
+    if constexpr (std::is_enum_v<F>) {
+        std::underlying_type_t<F> n;
+        decodeField<_endian>(in, n);
+        f = static_cast<F>(n);
+    } else if constexpr (std::is_arithmetic_v<F>) {
+        std::memcpy(&f, in, sizeof(F));
+        f = autoFitEndian<_endian>(f);
+        in += sizeof(F);
+    } else if constexpr (std::is_array_v<F> || _IsStdArray<F>::value) {
+        for (auto & e : f) { decodeField<_endian>(in, e); }
+    } else {
+        std::apply([&](auto... ptrs) { (decodeField<_endian>(in, f.*ptrs), ...); },
+            StreamLayout<F>::fields);
+    }
+}
+
+/**
+ * Whether the memory of `F` is exactly its serialized form in native
+ * endian, so it can be copied whole. Sizes are checked at compile time,
+ * field order against member offsets once at run time.
+ */
+template <typename F>
+bool isFlatLayout() noexcept {
+    if constexpr (std::is_arithmetic_v<F> || std::is_enum_v<F>) {
+        return true;
+    } else if constexpr (std::is_array_v<F>) {
+        return isFlatLayout<std::remove_extent_t<F>>();
+    } else if constexpr (_IsStdArray<F>::value) {
+        return sizeof(F) == fieldSize<F>() && isFlatLayout<typename F::value_type>();
+    } else if constexpr (!std::is_trivially_copyable_v<F> || !std::is_default_constructible_v<F> ||
+            sizeof(F) != fieldSize<F>()) {
+        return false;
+    } else {
+        static bool const s_b = [] {
+            F obj{};
+            auto const * base = reinterpret_cast<unsigned char const *>(&obj);
+            std::size_t expected = 0;
+            return std::apply([&](auto... ptrs) {
+                auto check = [&](auto ptr) {
+                    using M = _member_t<decltype(ptr)>;
+                    auto const offset = std::size_t(reinterpret_cast<unsigned char const *>(&(obj.*ptr)) - base);
+                    bool const b_ok = offset == expected && isFlatLayout<M>();
+                    expected += fieldSize<M>();
+                    return b_ok;
+                };
+                return (true && ... && check(ptrs));
+            }, StreamLayout<F>::fields);
+        }();
+        return s_b;
+    }
+}
+}
+}
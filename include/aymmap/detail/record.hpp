@@ -0,0 +1,122 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "aymmap/detail/endian.hpp"
+
+namespace aymmap {
+/**
+ * Unchecked cursor over one record of a stream, obtained from
+ * `BasicMMapStream::record` or `readRecord` after a single bounds check.
+ *
+ * Field reads and writes only assert in debug builds and never touch the
+ * stream status, so staying within `size()` is up to the caller. Writes
+ * are available when `ByteT` is not const.
+ */
+template <Endian _endian, typename ByteT>
+class BasicMMapRecord {
+    static_assert(sizeof(ByteT) == sizeof(char));
+    using self_type = BasicMMapRecord;
+    static constexpr bool kWritable = !std::is_const_v<ByteT>;
+public:
+    using byte_type = std::remove_const_t<ByteT>;
+    using pointer   = ByteT *;
+    using size_type = std::size_t;
+
+    BasicMMapRecord() = default;
+    BasicMMapRecord(pointer p, size_type length) noexcept : m_p(p), m_length(length) {}
+
+    // False if the record could not be obtained.
+    explicit operator bool() const noexcept { return m_p != nullptr; }
+    pointer data() const noexcept { return m_p; }
+    size_type size() const noexcept { return m_length; }
+    size_type tell() const noexcept { return m_pos; }
+    size_type remaining() const noexcept { return m_length - m_pos; }
+
+    self_type & seek(size_type pos) noexcept {
+        assert(pos <= m_length);
+        m_pos = pos;
+        return *this;
+    }
+    self_type & skip(size_type length) noexcept { return seek(m_pos + length); }
+
+    // Field at byte `offset` of the record, the cursor is not moved.
+    template <typename T>
+    requires std::integral<T> || std::floating_point<T>
+    T load(size_type offset) const noexcept {
+        assert(offset + sizeof(T) <= m_length);
+        T n;
+        std::memcpy(&n, m_p + offset, sizeof(T));
+        return autoFitEndian<_endian>(n);
+    }
+
+    template <typename T>
+    requires (std::integral<T> || std::floating_point<T>) && kWritable
+    void store(size_type offset, T n) const noexcept {
+        assert(offset + sizeof(T) <= m_length);
+        n = autoFitEndian<_endian>(n);
+        std::memcpy(m_p + offset, &n, sizeof(T));
+    }
+
+    template <typename T>
+    requires std::integral<T> || std::floating_point<T>
+    T get() noexcept {
+        auto n = load<T>(m_pos);
+        m_pos += sizeof(T);
+        return n;
+    }
+
+    template <typename T>
+    requires std::integral<T> || std::floating_point<T>
+    self_type & operator>>(T & n) noexcept {
+        n = get<T>();
+        return *this;
+    }
+
+    template <typename T>
+    requires (std::integral<T> || std::floating_point<T>) && kWritable
+    self_type & operator<<(T n) noexcept {
+        store(m_pos, n);
+        m_pos += sizeof(T);
+        return *this;
+    }
+
+    self_type & read(byte_type * data, size_type length) noexcept {
+        assert(m_pos + length <= m_length);
+        std::memcpy(data, m_p + m_pos, length);
+        m_pos += length;
+        return *this;
+    }
+
+    self_type & write(byte_type const * data, size_type length) noexcept requires kWritable {
+        assert(m_pos + length <= m_length);
+        std::memcpy(m_p + m_pos, data, length);
+        m_pos += length;
+        return *this;
+    }
+
+private:
+    pointer   m_p = nullptr;
+    size_type m_length = 0;
+    size_type m_pos = 0;
+};
+}
@@ -0,0 +1,209 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+
+#include "aymmap/detail/simd.hpp"
+
+namespace aymmap::detail {
+#ifdef _AYMMAP_SIMD_X86
+inline char const * _findByteSSE2(char const * p, char const * end, char c) noexcept {
+    auto const needle = _mm_set1_epi8(c);
+    for (; end - p >= 16; p += 16) {
+        auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+        auto const mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+        if (mask) { return p + std::countr_zero(mask); }
+    }
+    return static_cast<char const *>(std::memchr(p, c, std::size_t(end - p)));
+}
+
+_AYMMAP_TARGET_AVX2
+inline char const * _findByteAVX2(char const * p, char const * end, char c) noexcept {
+    auto const needle = _mm256_set1_epi8(c);
+    for (; end - p >= 64; p += 64) {
+        auto const lo = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(p)), needle);
+        auto const hi = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(p + 32)), needle);
+        auto const any = _mm256_or_si256(lo, hi);
+        if (_mm256_testz_si256(any, any)) { continue; }
+        auto const mask = std::uint64_t(unsigned(_mm256_movemask_epi8(lo))) |
+            (std::uint64_t(unsigned(_mm256_movemask_epi8(hi))) << 32);
+        return p + std::countr_zero(mask);
+    }
+    return _findByteSSE2(p, end, c);
+}
+
+// Offsets of the matches, one bit mask per block.
+inline std::size_t _findEachSSE2(char const * beg, char const * end, char c,
+    std::size_t * out, std::size_t max_count) noexcept {
+    auto const needle = _mm_set1_epi8(c);
+    std::size_t count = 0;
+    auto * p = beg;
+    for (; end - p >= 16; p += 16) {
+        auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(p));
+        auto mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+        while (mask) {
+            out[count++] = std::size_t(p - beg) + std::countr_zero(mask);
+            if (count == max_count) { return count; }
+            mask &= mask - 1;
+        }
+    }
+    for (; p < end; ++p) {
+        if (*p != c) { continue; }
+        out[count++] = std::size_t(p - beg);
+        if (count == max_count) { break; }
+    }
+    return count;
+}
+
+_AYMMAP_TARGET_AVX2
+inline std::size_t _findEachAVX2(char const * beg, char const * end, char c,
+    std::size_t * out, std::size_t max_count) noexcept {
+    auto const needle = _mm256_set1_epi8(c);
+    std::size_t count = 0;
+    auto * p = beg;
+    for (; end - p >= 32; p += 32) {
+        auto const block = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p));
+        auto mask = unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+        while (mask) {
+            out[count++] = std::size_t(p - beg) + std::countr_zero(mask);
+            if (count == max_count) { return count; }
+            mask &= mask - 1;
+        }
+    }
+    if (p == end) { return count; }
+    auto const tail = _findEachSSE2(p, end, c, out + count, max_count - count);
+    for (std::size_t i = count; i < count + tail; ++i) { out[i] += std::size_t(p - beg); }
+    return count + tail;
+}
+
+#endif
+
+/**
+ * First byte equal to `c` in `[p, p + n)`, `nullptr` if none.
+ * Vectorized with AVX2 or SSE2 where available, `memchr` otherwise.
+ */
+inline char const * findByte(char const * p, std::size_t n, char c) noexcept {
+#ifdef _AYMMAP_SIMD_X86
+    if (_hasAVX2()) { return _findByteAVX2(p, p + n, c); }
+    return _findByteSSE2(p, p + n, c);
+#else
+    return static_cast<char const *>(std::memchr(p, c, n));
+#endif
+}
+
+/**
+ * Offsets of the first `max_count` bytes equal to `c` in `[p, p + n)`,
+ * return how many were stored in `out`. Scanning a block at a time keeps
+ * short records from paying a call per match.
+ */
+inline std::size_t findEach(char const * p, std::size_t n, char c,
+    std::size_t * out, std::size_t max_count) noexcept {
+    if (max_count == 0) [[unlikely]] { return 0; }
+#ifdef _AYMMAP_SIMD_X86
+    if (_hasAVX2()) { return _findEachAVX2(p, p + n, c, out, max_count); }
+    return _findEachSSE2(p, p + n, c, out, max_count);
+#else
+    std::size_t count = 0;
+    auto const * beg = p;
+    auto const * end = p + n;
+    while (count < max_count && p < end) {
+        p = static_cast<char const *>(std::memchr(p, c, std::size_t(end - p)));
+        if (!p) { break; }
+        out[count++] = std::size_t(p - beg);
+        ++p;
+    }
+    return count;
+#endif
+}
+
+template <typename ByteT>
+ByteT const * findByte(ByteT const * p, std::size_t n, ByteT c) noexcept {
+    static_assert(sizeof(ByteT) == 1);
+    return reinterpret_cast<ByteT const *>(
+        findByte(reinterpret_cast<char const *>(p), n, static_cast<char>(c)));
+}
+
+/**
+ * Forward range over the lines of a byte span, each including its
+ * separator. The last line may lack one.
+ */
+template <typename ByteT>
+class LineRange {
+public:
+    using view_type = std::basic_string_view<ByteT>;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = view_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = view_type const *;
+        using reference         = view_type const &;
+
+        iterator() = default;
+        iterator(ByteT const * p, ByteT const * end, ByteT sep) noexcept
+            : m_end(end), m_sep(sep) { _load(p); }
+
+        reference operator*() const noexcept { return m_line; }
+        pointer operator->() const noexcept { return &m_line; }
+        iterator & operator++() noexcept {
+            _load(m_line.data() + m_line.size());
+            return *this;
+        }
+        iterator operator++(int) noexcept {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        friend bool operator==(iterator const & a, iterator const & b) noexcept {
+            return a.m_line.data() == b.m_line.data();
+        }
+
+    private:
+        void _load(ByteT const * p) noexcept {
+            if (p == m_end) {
+                m_line = view_type{};
+                return;
+            }
+            auto const * found = findByte(p, std::size_t(m_end - p), m_sep);
+            m_line = view_type(p, found ? std::size_t(found - p) + 1 : std::size_t(m_end - p));
+        }
+
+        ByteT const * m_end = nullptr;
+        ByteT         m_sep{};
+        view_type     m_line;
+    };
+
+    LineRange() = default;
+    LineRange(view_type view, ByteT sep) noexcept : m_view(view), m_sep(sep) {}
+
+    iterator begin() const noexcept {
+        if (m_view.empty()) { return end(); }
+        return iterator(m_view.data(), m_view.data() + m_view.size(), m_sep);
+    }
+    iterator end() const noexcept { return iterator{}; }
+
+private:
+    view_type m_view;
+    ByteT     m_sep{};
+};
+}
@@ -0,0 +1,56 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define _AYMMAP_SIMD_X86
+#endif
+
+#ifdef _AYMMAP_SIMD_X86
+namespace aymmap::detail {
+// Kernels for newer extensions are compiled per function and picked at run time.
+#if defined(__GNUC__) || defined(__clang__)
+#define _AYMMAP_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define _AYMMAP_TARGET_AVX2  __attribute__((target("avx2")))
+inline bool _hasSSSE3() noexcept {
+    static bool const s_b = __builtin_cpu_supports("ssse3");
+    return s_b;
+}
+inline bool _hasAVX2() noexcept {
+    static bool const s_b = __builtin_cpu_supports("avx2");
+    return s_b;
+}
+#else
+#define _AYMMAP_TARGET_SSSE3
+#define _AYMMAP_TARGET_AVX2
+inline bool _hasSSSE3() noexcept {
+#if defined(__SSSE3__) || defined(__AVX__)
+    return true;
+#else
+    return false;
+#endif
+}
+inline bool _hasAVX2() noexcept {
+#ifdef __AVX2__
+    return true;
+#else
+    return false;
+#endif
+}
+#endif
+}
+#endif
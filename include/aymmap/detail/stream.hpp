@@ -17,11 +17,17 @@
 
 #include <cstddef>
 #include <concepts>
+#include <cstring>
 #include <type_traits>
 #include <algorithm>
+#include <span>
 
 #include "aymmap/global.hpp"
+#include "aymmap/detail/bswap.hpp"
+#include "aymmap/detail/codec.hpp"
 #include "aymmap/detail/endian.hpp"
+#include "aymmap/detail/layout.hpp"
+#include "aymmap/detail/record.hpp"
 
 namespace aymmap {
 template <Endian _endian, typename BufT>
@@ -35,6 +41,9 @@ public:
     using pointer       = typename buffer_type::pointer;
     using const_pointer = typename buffer_type::const_pointer;
 
+    using record_type       = BasicMMapRecord<_endian, byte_type>;
+    using const_record_type = BasicMMapRecord<_endian, byte_type const>;
+
     static constexpr auto npos = buffer_type::npos;
 
     enum class Status {
@@ -95,6 +104,307 @@ public:
 
     void flush() noexcept { m_buf.flush(); }
 
+    /**
+     * Take the next `length` bytes as one record, checked once up front.
+     * On failure the status is set and the returned record is empty.
+     * `record` marks the bytes written and needs a buffer with contiguous
+     * writable spans; `readRecord` works on any buffer, and its record stays
+     * valid until the buffer moves its view (e.g. a window slides).
+     */
+    record_type record(size_type length) noexcept
+    requires requires(buffer_type & b) { b.template writeSpan<byte_type>(length); } {
+        if (!_check()) [[unlikely]] { return {}; }
+        if (!_reserve(length)) [[unlikely]] {
+            setStatus(Status::kWriteFailed);
+            return {};
+        }
+        auto sp = m_buf.template writeSpan<byte_type>(length);
+        return record_type{sp.data(), length};
+    }
+
+    const_record_type readRecord(size_type length) noexcept {
+        if (!_check()) [[unlikely]] { return {}; }
+        if (remaining() < length) [[unlikely]] {
+            setStatus(Status::kReadFailed);
+            return {};
+        }
+        auto view = m_buf.readView(length);
+        if (view.size() != length) [[unlikely]] {
+            setStatus(Status::kReadFailed);
+            return {};
+        }
+        return const_record_type{view.data(), length};
+    }
+
+    /**
+     * Read `count` values with one bounds check and one copy, then convert
+     * them in place in bulk. Nothing is read if fewer than `count` remain.
+     */
+    template <typename T>
+    requires std::integral<T> || std::floating_point<T>
+    size_type readArray(T * data, size_type count) noexcept {
+        if (!_check()) [[unlikely]] { return 0; }
+        // an empty span may have no data to pass to memcpy
+        if (count == 0) [[unlikely]] { return 0; }
+        auto const length = count * sizeof(T);
+        if (remaining() < length) [[unlikely]] {
+            setStatus(Status::kReadFailed);
+            return 0;
+        }
+        if (m_buf.read(reinterpret_cast<pointer>(data), length) != length) [[unlikely]] {
+            setStatus(Status::kReadFailed);
+            return 0;
+        }
+        detail::fitEndianCopy<_endian, T>(data, data, count);
+        return count;
+    }
+    template <typename T, std::size_t _extent>
+    requires std::integral<T> || std::floating_point<T> || StreamDescribed<T>
+    size_type readArray(std::span<T, _extent> out) noexcept { return readArray(out.data(), out.size()); }
+
+    // Write `count` values converted in bulk, nothing if fewer than `count` fit.
+    template <typename T>
+    requires std::integral<T> || std::floating_point<T>
+    size_type writeArray(T const * data, size_type count) noexcept {
+        if (!_check()) [[unlikely]] { return 0; }
+        if (count == 0) [[unlikely]] { return 0; }
+        auto const length = count * sizeof(T);
+        if (!_reserve(length)) [[unlikely]] {
+            setStatus(Status::kWriteFailed);
+            return 0;
+        }
+        if constexpr (requires { m_buf.template writeSpan<byte_type>(length); }) {
+            auto dst = m_buf.template writeSpan<byte_type>(length);
+            detail::fitEndianCopy<_endian, T>(dst.data(), data, count);
+        } else if constexpr (_endian == Endian::native || sizeof(T) == 1) {
+            if (m_buf.write(reinterpret_cast<const_pointer>(data), length) != length) [[unlikely]] {
+                setStatus(Status::kWriteFailed);
+                return 0;
+            }
+        } else {
+            // no contiguous destination, convert through a small staging block
+            constexpr size_type kBlock = 4096 / sizeof(T);
+            T block[kBlock];
+            for (size_type i = 0; i < count; i += kBlock) {
+                auto const n = std::min(kBlock, count - i);
+                detail::byteswapCopy(block, data + i, n, sizeof(T));
+                if (m_buf.write(reinterpret_cast<const_pointer>(block), n * sizeof(T)) != n * sizeof(T)) [[unlikely]] {
+                    setStatus(Status::kWriteFailed);
+                    return i;
+                }
+            }
+        }
+        return count;
+    }
+    template <typename T, std::size_t _extent>
+    requires std::integral<std::remove_const_t<T>> || std::floating_point<std::remove_const_t<T>> ||
+        StreamDescribed<std::remove_const_t<T>>
+    size_type writeArray(std::span<T, _extent> in) noexcept {
+        return writeArray<std::remove_const_t<T>>(in.data(), in.size());
+    }
+
+    /**
+     * Structs described by `StreamLayout` go out field by field in the
+     * stream endian. When that is native and the struct memory matches its
+     * serialized form (`detail::isFlatLayout`), the whole array is one copy.
+     */
+    template <StreamDescribed T>
+    size_type readArray(T * data, size_type count) noexcept {
+        constexpr size_type kSize = detail::kStreamSize<T>;
+        if (!_check()) [[unlikely]] { return 0; }
+        if (count == 0) [[unlikely]] { return 0; }
+        if (remaining() / kSize < count) [[unlikely]] {
+            setStatus(Status::kReadFailed);
+            return 0;
+        }
+        if (_endian == Endian::native && detail::isFlatLayout<T>()) {
+            if (m_buf.read(reinterpret_cast<pointer>(data), count * kSize) != count * kSize) [[unlikely]] {
+                setStatus(Status::kReadFailed);
+                return 0;
+            }
+            return count;
+        }
+        constexpr size_type kBatch = kSize < 4096 ? 4096 / kSize : 1;
+        for (size_type i = 0; i < count; i += kBatch) {
+            auto const n = std::min(kBatch, count - i);
+            auto view = m_buf.readView(n * kSize);
+            if (view.size() != n * kSize) [[unlikely]] {
+                setStatus(Status::kReadFailed);
+                return i;
+            }
+            auto const * p = reinterpret_cast<unsigned char const *>(view.data());
+            for (size_type j = 0; j < n; ++j) { detail::decodeField<_endian>(p, data[i + j]); }
+        }
+        return count;
+    }
+
+    template <StreamDescribed T>
+    size_type writeArray(T const * data, size_type count) noexcept {
+        constexpr size_type kSize = detail::kStreamSize<T>;
+        if (!_check()) [[unlikely]] { return 0; }
+        if (count == 0) [[unlikely]] { return 0; }
+        if (!_reserve(count * kSize)) [[unlikely]] {
+            setStatus(Status::kWriteFailed);
+            return 0;
+        }
+        if (_endian == Endian::native && detail::isFlatLayout<T>()) {
+            if (m_buf.write(reinterpret_cast<const_pointer>(data), count * kSize) != count * kSize) [[unlikely]] {
+                setStatus(Status::kWriteFailed);
+                return 0;
+            }
+            return count;
+        }
+        if constexpr (requires { m_buf.template writeSpan<byte_type>(count); }) {
+            auto * p = reinterpret_cast<unsigned char *>(m_buf.template writeSpan<byte_type>(count * kSize).data());
+            for (size_type i = 0; i < count; ++i) { detail::encodeField<_endian>(data[i], p); }
+        } else {
+            constexpr size_type kBatch = kSize < 4096 ? 4096 / kSize : 1;
+            unsigned char block[kBatch * kSize];
+            for (size_type i = 0; i < count; i += kBatch) {
+                auto const n = std::min(kBatch, count - i);
+                auto * p = block;
+                for (size_type j = 0; j < n; ++j) { detail::encodeField<_endian>(data[i + j], p); }
+                if (m_buf.write(reinterpret_cast<const_pointer>(block), n * kSize) != n * kSize) [[unlikely]] {
+                    setStatus(Status::kWriteFailed);
+                    return i;
+                }
+            }
+        }
+        return count;
+    }
+
+    template <StreamDescribed T>
+    self_type & operator>>(T & v) {
+        readArray(&v, 1);
+        return *this;
+    }
+
+    template <StreamDescribed T>
+    self_type & operator<<(T const & v) {
+        writeArray(&v, 1);
+        return *this;
+    }
+
+    // LEB128 varint, signed values are zigzag encoded first.
+    template <std::integral T>
+    self_type & writeVarint(T n) noexcept {
+        unsigned char bytes[detail::kMaxVarintSize];
+        auto const length = detail::encodeVarint(std::uint64_t(detail::zigzagEncode(n)), bytes);
+        if (write(reinterpret_cast<const_pointer>(bytes), length) != length) {
+            setStatus(Status::kWriteFailed);
+        }
+        return *this;
+    }
+
+    template <std::integral T>
+    self_type & readVarint(T & n) noexcept {
+        n = T{0};
+        if (!_check()) [[unlikely]] { return *this; }
+        auto view = m_buf.readView(std::min<size_type>(detail::kMaxVarintSize, remaining()));
+        auto const * p = reinterpret_cast<unsigned char const *>(view.data());
+        std::uint64_t u = 0;
+        auto const length = detail::decodeVarint(p, p + view.size(), u);
+        if (length == 0 || u > std::uint64_t(std::make_unsigned_t<T>(-1))) [[unlikely]] {
+            setStatus(Status::kReadFailed);
+            return *this;
+        }
+        m_buf.seek(off_type(length) - off_type(view.size()));
+        n = detail::zigzagDecode<T>(std::make_unsigned_t<T>(u));
+        return *this;
+    }
+
+    /**
+     * Bit-packed integers: a varint count, then blocks of 128 values, each
+     * a width byte, the block minimum, and the deltas from it packed at that
+     * width (`detail::packBlock`). 64-bit blocks whose range exceeds 32 bits
+     * are stored raw. The last block is padded.
+     */
+    template <std::integral T>
+    requires (sizeof(T) == 4 || sizeof(T) == 8)
+    size_type writePacked(T const * data, size_type count) noexcept {
+        using U = std::make_unsigned_t<T>;
+        constexpr auto kBlock = detail::kPackBlock;
+        writeVarint(std::uint64_t(count));
+        std::uint32_t deltas[kBlock];
+        unsigned char out[1 + sizeof(T) + kBlock * sizeof(T)];
+        for (size_type beg = 0; beg < count && _check(); beg += kBlock) {
+            auto const n = std::min<size_type>(kBlock, count - beg);
+            auto const [p_min, p_max] = std::minmax_element(data + beg, data + beg + n);
+            auto const ref = *p_min;
+            size_type length = 1 + sizeof(T);
+            if (U(U(*p_max) - U(ref)) > U(UINT32_MAX)) {
+                out[0] = 64;
+                detail::fitEndianCopy<_endian, T>(out + length, data + beg, n);
+                std::memset(out + length + n * sizeof(T), 0, (kBlock - n) * sizeof(T));
+                length += kBlock * sizeof(T);
+            } else {
+                for (size_type i = 0; i < n; ++i) { deltas[i] = std::uint32_t(U(data[beg + i]) - U(ref)); }
+                std::fill(deltas + n, deltas + kBlock, 0u);
+                auto const width = detail::packWidth(deltas);
+                out[0] = static_cast<unsigned char>(width);
+                detail::packBlock(deltas, width, out + length);
+                length += detail::packedBlockSize(width);
+            }
+            auto const ref_n = autoFitEndian<_endian>(ref);
+            std::memcpy(out + 1, &ref_n, sizeof(T));
+            if (write(reinterpret_cast<const_pointer>(out), length) != length) {
+                setStatus(Status::kWriteFailed);
+            }
+        }
+        return _check() ? count : 0;
+    }
+    template <typename T, std::size_t _extent>
+    requires std::integral<std::remove_const_t<T>>
+    size_type writePacked(std::span<T, _extent> in) noexcept {
+        return writePacked<std::remove_const_t<T>>(in.data(), in.size());
+    }
+
+    // Decode values written by `writePacked`, fails if more than `max_count` are stored.
+    template <std::integral T>
+    requires (sizeof(T) == 4 || sizeof(T) == 8)
+    size_type readPacked(T * data, size_type max_count) noexcept {
+        using U = std::make_unsigned_t<T>;
+        constexpr auto kBlock = detail::kPackBlock;
+        std::uint64_t count = 0;
+        readVarint(count);
+        if (!_check()) [[unlikely]] { return 0; }
+        if (count > max_count) [[unlikely]] {
+            setStatus(Status::kReadFailed);
+            return 0;
+        }
+        if (count == 0) { return 0; }
+        std::uint32_t deltas[kBlock];
+        for (size_type beg = 0; beg < count; beg += kBlock) {
+            auto const n = std::min<size_type>(kBlock, size_type(count) - beg);
+            auto head = m_buf.readView(1 + sizeof(T));
+            if (head.size() != 1 + sizeof(T)) [[unlikely]] { break; }
+            unsigned const width = static_cast<unsigned char>(head[0]);
+            T ref;
+            std::memcpy(&ref, head.data() + 1, sizeof(T));
+            ref = autoFitEndian<_endian>(ref);
+            if (width > 32 && !(width == 64 && sizeof(T) == 8)) [[unlikely]] { break; }
+            auto const length = width == 64 ? kBlock * sizeof(T) : detail::packedBlockSize(width);
+            auto body = m_buf.readView(length);
+            if (body.size() != length) [[unlikely]] { break; }
+            auto const * p = reinterpret_cast<unsigned char const *>(body.data());
+            if (width == 64) {
+                detail::fitEndianCopy<_endian, T>(data + beg, p, n);
+            } else if (sizeof(T) == 4 && n == kBlock) {
+                // decode straight into the output
+                detail::unpackBlock(p, width, std::uint32_t(ref), reinterpret_cast<std::uint32_t *>(data + beg));
+            } else {
+                detail::unpackBlock(p, width, 0, deltas);
+                for (size_type i = 0; i < n; ++i) { data[beg + i] = T(U(U(ref) + deltas[i])); }
+            }
+            if (beg + n == count) { return size_type(count); }
+        }
+        setStatus(Status::kReadFailed);
+        return 0;
+    }
+    template <typename T, std::size_t _extent>
+    requires std::integral<T>
+    size_type readPacked(std::span<T, _extent> out) noexcept { return readPacked(out.data(), out.size()); }
+
     template <std::integral T>
     self_type & operator>>(T & i) {
         if (read(reinterpret_cast<pointer>(&i), sizeof(T)) != sizeof(T)) {
@@ -146,6 +456,15 @@ private:
         return true;
     }
 
+    // Whether `length` bytes can be written, growing the buffer if it supports it.
+    bool _reserve(size_type length) noexcept {
+        if constexpr (requires { m_buf.reserve(length); }) {
+            return m_buf.reserve(length);
+        } else {
+            return remaining() >= length;
+        }
+    }
+
     _AYMMAP_DISABLE_CLASS_COPY(BasicMMapStream)
 
 private:
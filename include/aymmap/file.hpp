@@ -21,5 +21,15 @@
 #include "aymmap/file/utils.hpp"
 #include "aymmap/file/mmap.hpp"
 #include "aymmap/file/buffer.hpp"
+#include "aymmap/file/window.hpp"
 #include "aymmap/file/stream.hpp"
+#include "aymmap/file/flusher.hpp"
+#include "aymmap/file/appender.hpp"
+#include "aymmap/file/queue.hpp"
+#include "aymmap/file/ring.hpp"
+#include "aymmap/file/arena.hpp"
+#include "aymmap/file/heap.hpp"
+#include "aymmap/file/vector.hpp"
+#include "aymmap/file/line_index.hpp"
+#include "aymmap/file/scan.hpp"
 
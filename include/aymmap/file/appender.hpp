@@ -0,0 +1,167 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+#include "aymmap/file/mmap.hpp"
+
+namespace aymmap {
+/**
+ * Multi-producer appender over a mapped file.
+ *
+ * Space is reserved with an atomic fetch-add on the tail, so appends never
+ * take a lock unless the reservation crosses the capacity. Growth resizes
+ * the file geometrically and publishes a new view of the whole file; older
+ * views stay mapped until `close`, so pointers returned by `reserve` remain
+ * valid while other threads grow the file. `close` trims the file to the
+ * appended length.
+ */
+template <typename FileT = MMapFile>
+class BasicMMapAppender {
+public:
+    using file_type     = FileT;
+    using traits_type   = typename file_type::traits_type;
+    using handle_type   = typename file_type::handle_type;
+    using path_cref     = typename file_type::path_cref;
+    using size_type     = typename file_type::size_type;
+    using byte_type     = typename file_type::byte_type;
+    using pointer       = typename file_type::pointer;
+    using const_pointer = typename file_type::const_pointer;
+
+    static constexpr auto npos = static_cast<size_type>(-1);
+
+    BasicMMapAppender() = default;
+    ~BasicMMapAppender() noexcept { close(); }
+
+    /**
+     * Open `ph` for appending after its current content.
+     */
+    errno_t open(path_cref ph, size_type initial_capacity = size_type(1) << 20) {
+        if (auto en = close()) { return en; }
+        auto handle = traits_type::fileOpen(ph, AccessFlag::kDefault);
+        if (!traits_type::checkHandle(handle)) [[unlikely]] { return file_type::_throwErrno(false); }
+        m_handle = handle;
+
+        auto const file_sz = traits_type::fileSize(handle);
+        m_tail.store(file_sz, std::memory_order_relaxed);
+        auto en = _addView(std::max({file_sz, initial_capacity, size_type(1)}));
+        if (en) { close(); }
+        return en;
+    }
+
+    // Must not race with appends.
+    errno_t close() noexcept {
+        if (!isOpen()) { return kEnoOk; }
+        m_view.store(nullptr, std::memory_order_relaxed);
+        m_views.clear();
+        errno_t en = kEnoOk;
+        if (!traits_type::fileResize(m_handle, size())) { en = file_type::_throwErrno(false); }
+        traits_type::fileClose(m_handle);
+        m_handle = kInvalidHandle;
+        m_tail.store(0, std::memory_order_relaxed);
+        return en;
+    }
+
+    bool isOpen() const noexcept { return m_handle != kInvalidHandle; }
+    // Bytes reserved so far, including reservations still being written.
+    size_type size() const noexcept { return m_tail.load(std::memory_order_relaxed); }
+    size_type capacity() const noexcept {
+        auto p_view = m_view.load(std::memory_order_acquire);
+        return p_view ? p_view->size() : 0;
+    }
+
+    /**
+     * Reserve `length` bytes at the tail and return where to write them.
+     * On failure `nullptr` is returned and the range is given back if no
+     * later reservation was made meanwhile; otherwise it stays in the file
+     * as a gap of zeros.
+     */
+    pointer reserve(size_type length, size_type * p_offset = nullptr) noexcept {
+        auto const offset = m_tail.fetch_add(length, std::memory_order_relaxed);
+        auto * p_view = m_view.load(std::memory_order_acquire);
+        if (p_view && offset + length > p_view->size()) [[unlikely]] {
+            p_view = _grow(offset + length);
+        }
+        if (!p_view) [[unlikely]] {
+            auto tail = offset + length;
+            m_tail.compare_exchange_strong(tail, offset, std::memory_order_relaxed);
+            return nullptr;
+        }
+        if (p_offset) { *p_offset = offset; }
+        return p_view->data() + offset;
+    }
+
+    // Offset of the appended record, `npos` on failure.
+    size_type append(const_pointer data, size_type length) noexcept {
+        size_type offset = npos;
+        auto p = reserve(length, &offset);
+        if (!p) [[unlikely]] { return npos; }
+        std::memcpy(p, data, length);
+        return offset;
+    }
+
+    errno_t flush(bool b_async = false) {
+        auto * p_view = m_view.load(std::memory_order_acquire);
+        if (!p_view) [[unlikely]] { return kEnoUnmapped; }
+        auto const length = std::min(size(), p_view->size());
+        if (length == 0) { return kEnoOk; }
+        return p_view->sync(0, length, b_async);
+    }
+
+private:
+    errno_t _addView(size_type capacity) {
+        auto const page_size = size_type(file_type::pageSize());
+        capacity = (capacity + page_size - 1) & ~(page_size - 1);
+        file_type fi;
+        if (auto en = fi.fileMap(m_handle, AccessFlag::kDefault, false, capacity)) { return en; }
+        m_views.push_back(std::move(fi));
+        m_view.store(&m_views.back(), std::memory_order_release);
+        return kEnoOk;
+    }
+
+    file_type * _grow(size_type required) noexcept {
+        std::lock_guard lk(m_mtx);
+        auto * p_view = m_view.load(std::memory_order_acquire);
+        if (!p_view) [[unlikely]] { return nullptr; }
+        if (p_view->size() >= required) { return p_view; }
+        try {
+            if (auto en = _addView(std::max(required, p_view->size() * 2))) {
+                AYMMAP_DEBUG("Failed to grow the appender: ", en);
+                return nullptr;
+            }
+        } catch (...) {
+            return nullptr;
+        }
+        return m_view.load(std::memory_order_relaxed);
+    }
+
+    _AYMMAP_DISABLE_CLASS_COPY(BasicMMapAppender)
+
+private:
+    std::atomic<size_type>   m_tail{0};
+    std::atomic<file_type *> m_view{nullptr};
+    std::deque<file_type>    m_views;
+    std::mutex  m_mtx;
+    handle_type m_handle = kInvalidHandle;
+};
+using MMapAppender = BasicMMapAppender<MMapFile>;
+}
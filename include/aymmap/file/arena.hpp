@@ -0,0 +1,422 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "aymmap/file/mmap.hpp"
+
+namespace aymmap {
+struct ArenaPolicy {
+    // address space mapped at once, slabs are carved out of it
+    std::size_t region_size = std::size_t(64) << 20;
+    // minimum bytes carved per size class refill
+    std::size_t slab_size = std::size_t(256) << 10;
+    // bytes cached per size class in each thread
+    std::size_t cache_bytes = std::size_t(256) << 10;
+    // blocks cached per size class in each thread
+    std::size_t cache_count = 64;
+    // bytes of freed large mappings kept for reuse
+    std::size_t pool_bytes = std::size_t(256) << 20;
+};
+
+/**
+ * Size-class allocator over anonymous mappings.
+ *
+ * Requests up to `kMaxSmall` bytes are rounded to one of four classes per
+ * power of two and served from slabs carved out of large regions, through
+ * a per-thread cache first and a per-class central list second. Larger
+ * requests get a mapping of their own; freed ones are kept in a pool with
+ * `MADV_FREE` applied, so bursts of large buffers reuse mappings instead of
+ * calling `mmap` / `munmap` each time.
+ *
+ * Deallocation must pass the size and alignment used to allocate. The
+ * arena must outlive every thread that used it.
+ */
+template <typename FileT = MMapFile>
+class BasicMMapArena {
+public:
+    using file_type = FileT;
+    using size_type = typename file_type::size_type;
+
+    static constexpr size_type kMinAlign  = 16;
+    static constexpr size_type kMaxSmall  = size_type(256) << 10;
+    static constexpr size_type kClassCount = 4 + (std::bit_width(kMaxSmall) - 7) * 4;
+
+    explicit BasicMMapArena(ArenaPolicy policy = ArenaPolicy{})
+        : m_policy(policy), m_uid(s_next_uid.fetch_add(1, std::memory_order_relaxed)) {
+        m_page_size = size_type(file_type::pageSize());
+    }
+
+    ~BasicMMapArena() {
+        std::vector<std::shared_ptr<_Cache>> caches;
+        {
+            std::lock_guard lk(m_cache_mtx);
+            caches.swap(m_caches);
+        }
+        for (auto & p_cache : caches) {
+            std::lock_guard lk(p_cache->mtx);
+            p_cache->p_arena.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ArenaPolicy const & policy() const noexcept { return m_policy; }
+    // Bytes of address space currently mapped, pooled mappings included.
+    size_type mappedBytes() const noexcept { return m_mapped.load(std::memory_order_relaxed); }
+    // Bytes of freed large mappings waiting for reuse.
+    size_type pooledBytes() const noexcept { return m_pooled.load(std::memory_order_relaxed); }
+
+    /**
+     * `nullptr` on failure or when `alignment` exceeds the page size.
+     */
+    void * allocate(size_type bytes, size_type alignment = alignof(std::max_align_t)) noexcept {
+        auto const cls = _classOf(bytes, alignment);
+        if (cls == kLarge) { return _allocateLarge(bytes, alignment); }
+        auto & bin = _threadCache().bins[cls];
+        if (!bin.p_head) [[unlikely]] {
+            if (!_refill(cls, bin)) { return nullptr; }
+        }
+        auto * p_block = bin.p_head;
+        bin.p_head = p_block->p_next;
+        --bin.count;
+        return p_block;
+    }
+
+    void deallocate(void * p, size_type bytes, size_type alignment = alignof(std::max_align_t)) noexcept {
+        if (!p) [[unlikely]] { return; }
+        auto const cls = _classOf(bytes, alignment);
+        if (cls == kLarge) { return _deallocateLarge(p); }
+        auto & bin = _threadCache().bins[cls];
+        auto * p_block = static_cast<_Block *>(p);
+        p_block->p_next = bin.p_head;
+        bin.p_head = p_block;
+        if (++bin.count > _cacheLimit(cls)) [[unlikely]] { _drain(cls, bin, bin.count / 2); }
+    }
+
+    // Unmap the pooled large mappings.
+    void trim() {
+        std::multimap<size_type, file_type> pool;
+        {
+            std::lock_guard lk(m_large_mtx);
+            pool.swap(m_pool);
+            m_pooled.store(0, std::memory_order_relaxed);
+        }
+        for (auto & [length, fi] : pool) { m_mapped.fetch_sub(length, std::memory_order_relaxed); }
+    }
+
+    // Size class of a small request, or a value past the last class.
+    static constexpr size_type sizeClass(size_type bytes) noexcept {
+        if (bytes <= 64) { return bytes ? (bytes - 1) / 16 : 0; }
+        if (bytes > kMaxSmall) { return kLarge; }
+        auto const p    = size_type(std::bit_width(bytes - 1) - 1);
+        auto const step = size_type(1) << (p - 2);
+        auto const k    = (bytes - (size_type(1) << p) + step - 1) / step;
+        return 4 + (p - 6) * 4 + (k - 1);
+    }
+
+    static constexpr size_type classSize(size_type cls) noexcept {
+        if (cls < 4) { return (cls + 1) * 16; }
+        auto const p = 6 + (cls - 4) / 4;
+        auto const k = (cls - 4) % 4 + 1;
+        return (size_type(1) << p) + k * (size_type(1) << (p - 2));
+    }
+
+private:
+    static constexpr size_type kLarge = static_cast<size_type>(-1);
+
+    struct _Block {
+        _Block * p_next;
+    };
+
+    struct _Bin {
+        _Block *  p_head = nullptr;
+        size_type count  = 0;
+    };
+
+    struct alignas(64) _Central {
+        std::mutex mtx;
+        _Block *   p_head = nullptr;
+        char *     p_bump = nullptr;
+        char *     p_bump_end = nullptr;
+    };
+
+    struct _Cache {
+        std::mutex mtx;
+        std::atomic<BasicMMapArena *> p_arena;
+        std::array<_Bin, kClassCount> bins{};
+
+        explicit _Cache(BasicMMapArena * p) : p_arena(p) {}
+    };
+
+    // Caches of the calling thread, returned to their arenas on thread exit.
+    struct _ThreadCaches {
+        std::uint64_t last_uid = 0;
+        _Cache *      p_last   = nullptr;
+        std::vector<std::pair<std::uint64_t, std::shared_ptr<_Cache>>> caches;
+
+        ~_ThreadCaches() {
+            for (auto & [uid, p_cache] : caches) {
+                std::lock_guard lk(p_cache->mtx);
+                if (auto * p_arena = p_cache->p_arena.load(std::memory_order_relaxed)) {
+                    p_arena->_release(*p_cache);
+                }
+            }
+        }
+    };
+
+    size_type _classOf(size_type bytes, size_type alignment) const noexcept {
+        if (alignment > kMinAlign) {
+            if (alignment > m_page_size) [[unlikely]] { return kLarge; }
+            // power-of-two classes inside page-aligned slabs are self-aligned
+            bytes = std::bit_ceil(std::max(bytes, alignment));
+        }
+        return sizeClass(bytes);
+    }
+
+    size_type _cacheLimit(size_type cls) const noexcept {
+        return std::max<size_type>(1,
+            std::min<size_type>(m_policy.cache_count, m_policy.cache_bytes / classSize(cls)));
+    }
+
+    _Cache & _threadCache() {
+        thread_local _ThreadCaches tls;
+        if (tls.last_uid == m_uid) [[likely]] { return *tls.p_last; }
+
+        auto iter = std::find_if(tls.caches.begin(), tls.caches.end(),
+            [this](auto const & e) { return e.first == m_uid; });
+        if (iter == tls.caches.end()) {
+            // forget caches of destroyed arenas
+            std::erase_if(tls.caches, [](auto const & e) {
+                return !e.second->p_arena.load(std::memory_order_relaxed);
+            });
+            auto p_cache = std::make_shared<_Cache>(this);
+            {
+                std::lock_guard lk(m_cache_mtx);
+                m_caches.push_back(p_cache);
+            }
+            tls.caches.emplace_back(m_uid, std::move(p_cache));
+            iter = std::prev(tls.caches.end());
+        }
+        tls.last_uid = m_uid;
+        tls.p_last   = iter->second.get();
+        return *tls.p_last;
+    }
+
+    // Called with `cache.mtx` held when the owning thread exits.
+    void _release(_Cache & cache) {
+        for (size_type cls = 0; cls < kClassCount; ++cls) {
+            auto & bin = cache.bins[cls];
+            if (bin.count) { _drain(cls, bin, bin.count); }
+        }
+        std::lock_guard lk(m_cache_mtx);
+        std::erase_if(m_caches, [&cache](auto const & p) { return p.get() == &cache; });
+    }
+
+    // Move `n` blocks from the bin to the central list.
+    void _drain(size_type cls, _Bin & bin, size_type n) noexcept {
+        auto * p_first = bin.p_head;
+        auto * p_last  = p_first;
+        for (size_type i = 1; i < n; ++i) { p_last = p_last->p_next; }
+        bin.p_head = p_last->p_next;
+        bin.count -= n;
+
+        auto & central = m_centrals[cls];
+        std::lock_guard lk(central.mtx);
+        p_last->p_next = central.p_head;
+        central.p_head = p_first;
+    }
+
+    // Fill an empty bin with half its limit from the central list or slab.
+    bool _refill(size_type cls, _Bin & bin) noexcept {
+        auto const block_size = classSize(cls);
+        auto const n = std::max<size_type>(1, _cacheLimit(cls) / 2);
+        auto & central = m_centrals[cls];
+        std::lock_guard lk(central.mtx);
+        while (bin.count < n) {
+            _Block * p_block = central.p_head;
+            if (p_block) {
+                central.p_head = p_block->p_next;
+            } else {
+                if (central.p_bump == central.p_bump_end) {
+                    auto const slab_size = block_size *
+                        std::max<size_type>(8, m_policy.slab_size / block_size);
+                    auto * p_slab = _carve(slab_size);
+                    if (!p_slab) [[unlikely]] { break; }
+                    central.p_bump     = p_slab;
+                    central.p_bump_end = p_slab + slab_size;
+                }
+                p_block = reinterpret_cast<_Block *>(central.p_bump);
+                central.p_bump += block_size;
+            }
+            p_block->p_next = bin.p_head;
+            bin.p_head = p_block;
+            ++bin.count;
+        }
+        return bin.p_head != nullptr;
+    }
+
+    // Page-aligned slab of `length` bytes from the current region.
+    char * _carve(size_type length) noexcept {
+        std::lock_guard lk(m_region_mtx);
+        auto const offset = (m_region_used + m_page_size - 1) & ~(m_page_size - 1);
+        if (m_regions.empty() || offset + length > m_regions.back().size()) {
+            auto const region_size = std::max(m_policy.region_size, length);
+            try {
+                file_type fi;
+                // private, so freed pages can be given back lazily
+                if (auto en = fi.anonMap(region_size, AccessFlag::kWriteCopy)) {
+                    AYMMAP_DEBUG("Failed to map an arena region: ", en);
+                    return nullptr;
+                }
+                m_regions.push_back(std::move(fi));
+            } catch (...) {
+                return nullptr;
+            }
+            m_mapped.fetch_add(region_size, std::memory_order_relaxed);
+            m_region_used = length;
+            return m_regions.back().data();
+        }
+        m_region_used = offset + length;
+        return m_regions.back().data() + offset;
+    }
+
+    void * _allocateLarge(size_type bytes, size_type alignment) noexcept {
+        if (alignment > m_page_size) [[unlikely]] { return nullptr; }
+        auto const length = (std::max<size_type>(bytes, 1) + m_page_size - 1) & ~(m_page_size - 1);
+        try {
+            file_type fi;
+            {
+                std::lock_guard lk(m_large_mtx);
+                // best fit, at most twice the request
+                auto iter = m_pool.lower_bound(length);
+                if (iter != m_pool.end() && iter->first <= length * 2) {
+                    fi = std::move(iter->second);
+                    m_pooled.fetch_sub(iter->first, std::memory_order_relaxed);
+                    m_pool.erase(iter);
+                }
+            }
+            if (!fi.isMapped()) {
+                if (auto en = fi.anonMap(length, AccessFlag::kWriteCopy)) {
+                    AYMMAP_DEBUG("Failed to map a large block: ", en);
+                    return nullptr;
+                }
+                m_mapped.fetch_add(length, std::memory_order_relaxed);
+            }
+            void * p = fi.data();
+            std::lock_guard lk(m_large_mtx);
+            m_large.emplace(p, std::move(fi));
+            return p;
+        } catch (...) {
+            return nullptr;
+        }
+    }
+
+    void _deallocateLarge(void * p) noexcept {
+        file_type fi;
+        {
+            std::lock_guard lk(m_large_mtx);
+            auto iter = m_large.find(p);
+            if (iter == m_large.end()) [[unlikely]] { return; }
+            fi = std::move(iter->second);
+            m_large.erase(iter);
+        }
+        auto const length = fi.size();
+        if (m_pooled.load(std::memory_order_relaxed) + length <= m_policy.pool_bytes) {
+            // the kernel reclaims the pages only under memory pressure
+            if (fi.advise(AdviceFlag::kFree) != kEnoOk) { fi.advise(AdviceFlag::kDontNeed); }
+            try {
+                std::lock_guard lk(m_large_mtx);
+                m_pool.emplace(length, std::move(fi));
+                m_pooled.fetch_add(length, std::memory_order_relaxed);
+                return;
+            } catch (...) {}
+        }
+        m_mapped.fetch_sub(length, std::memory_order_relaxed);
+    }
+
+    _AYMMAP_DISABLE_CLASS_COPY(BasicMMapArena)
+
+private:
+    static inline std::atomic<std::uint64_t> s_next_uid{1};
+
+    ArenaPolicy         m_policy;
+    std::uint64_t const m_uid;
+    size_type           m_page_size = 0;
+
+    std::atomic<size_type> m_mapped{0};
+    std::atomic<size_type> m_pooled{0};
+
+    std::array<_Central, kClassCount> m_centrals;
+
+    std::mutex            m_region_mtx;
+    std::deque<file_type> m_regions;
+    size_type             m_region_used = 0;
+
+    std::mutex m_large_mtx;
+    std::unordered_map<void *, file_type> m_large;
+    std::multimap<size_type, file_type>   m_pool;
+
+    std::mutex m_cache_mtx;
+    std::vector<std::shared_ptr<_Cache>> m_caches;
+};
+using MMapArena = BasicMMapArena<MMapFile>;
+
+/**
+ * `std::pmr::memory_resource` over an arena.
+ */
+template <typename ArenaT = MMapArena>
+class BasicMMapMemoryResource : public std::pmr::memory_resource {
+public:
+    using arena_type = ArenaT;
+
+    explicit BasicMMapMemoryResource(arena_type & arena) noexcept : m_arena(arena) {}
+
+    arena_type & arena() const noexcept { return m_arena; }
+
+private:
+    void * do_allocate(std::size_t bytes, std::size_t alignment) override {
+        auto * p = m_arena.allocate(bytes, alignment);
+        if (!p) [[unlikely]] { throw std::bad_alloc(); }
+        return p;
+    }
+
+    void do_deallocate(void * p, std::size_t bytes, std::size_t alignment) override {
+        m_arena.deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const & ot) const noexcept override {
+        auto * p_ot = dynamic_cast<BasicMMapMemoryResource const *>(&ot);
+        return p_ot && &p_ot->m_arena == &m_arena;
+    }
+
+private:
+    arena_type & m_arena;
+};
+using MMapMemoryResource = BasicMMapMemoryResource<MMapArena>;
+}
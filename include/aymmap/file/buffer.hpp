@@ -15,17 +15,66 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <cstring>
 #include <string_view>
 #include <utility>
 
+#include "aymmap/detail/interval.hpp"
+#include "aymmap/detail/scan.hpp"
 #include "aymmap/file/mmap.hpp"
 
 namespace aymmap {
+enum class GrowthKind {
+    // writes stop at the end of the mapping
+    kNone = 0,
+    // capacity is multiplied by `factor`
+    kGeometric,
+    // capacity grows by multiples of `step`
+    kFixedStep,
+};
+
+struct GrowthPolicy {
+    GrowthKind  kind = GrowthKind::kNone;
+    double      factor = 2.0;
+    std::size_t step = std::size_t(1) << 20;
+    // capacity never grows past this
+    std::size_t max_size = static_cast<std::size_t>(-1);
+};
+
+/**
+ * Bounded streaming mode: as the cursor moves, the range ahead of it is
+ * read ahead and the pages left behind are unmapped and dropped from the
+ * page cache, so a one-pass scan of a huge file keeps neither RSS nor the
+ * cache polluted. Pages of a private (`kCopy`) mapping stay mapped, as
+ * dropping them would discard their writes.
+ */
+struct StreamingPolicy {
+    bool b_enabled = false;
+    // bytes ahead of the cursor to read ahead
+    std::size_t read_ahead = std::size_t(16) << 20;
+    // bytes behind the cursor left resident, e.g. for short seeks back
+    std::size_t keep_behind = std::size_t(1) << 20;
+    // cursor movement between two rounds of advice
+    std::size_t step = std::size_t(4) << 20;
+};
+
+/**
+ * Cursor over a mapped file.
+ *
+ * `size()` is the logical length: reads stop there and writes past it
+ * extend it, up to `capacity()`, the mapped length. With a growth policy,
+ * writes past the capacity resize the mapping (which may move it), and
+ * `close` trims the file to the logical length. Private (`kCopy`) file
+ * mappings never grow nor trim: their writes are discarded, so resizing
+ * would only change the file on disk. Shared anonymous mappings cannot
+ * grow either, private ones can.
+ */
 template <typename FileT = MMapFile>
 class BasicMMapFileBuf {
 public:
     using file_type     = FileT;
+    using traits_type   = typename file_type::traits_type;
     using size_type     = typename file_type::size_type;
     using off_type      = typename file_type::off_type;
     using byte_type     = typename file_type::byte_type;
@@ -33,14 +82,17 @@ public:
     using const_pointer = typename file_type::const_pointer;
 
     using view_type = std::basic_string_view<byte_type>;
+    using line_range_type = detail::LineRange<byte_type>;
+    using dirty_set_type = detail::IntervalSet<size_type>;
 
     static constexpr auto npos = static_cast<size_type>(-1);
 
     static_assert(sizeof(byte_type) == 1);
 
     BasicMMapFileBuf() = default;
-    ~BasicMMapFileBuf() = default;
-    explicit BasicMMapFileBuf(file_type && fi) noexcept : m_file(std::move(fi)), m_pos(0) {}
+    ~BasicMMapFileBuf() noexcept { close(); }
+    explicit BasicMMapFileBuf(file_type && fi) noexcept
+        : m_file(std::move(fi)), m_pos(0), m_size(m_file.size()) {}
     BasicMMapFileBuf(BasicMMapFileBuf && ot) noexcept { _move(std::move(ot)); }
     BasicMMapFileBuf & operator=(BasicMMapFileBuf && ot) noexcept {
         _move(std::move(ot));
@@ -51,26 +103,115 @@ public:
     file_type const & file() const noexcept { return m_file; }
     file_type setFile(file_type && fi = file_type{}) noexcept {
         m_pos = 0;
-        return std::exchange(m_file, fi);
+        clearDirty();
+        auto old = std::exchange(m_file, std::move(fi));
+        m_size = m_file.size();
+        _resetTracking();
+        return old;
     }
 
     template <typename... Ts>
     auto map(Ts... args) {
         m_pos = 0;
-        return m_file.map(std::forward<Ts>(args)...);
+        clearDirty();
+        auto en = m_file.map(std::forward<Ts>(args)...);
+        m_size = m_file.size();
+        _resetTracking();
+        return en;
+    }
+
+    // Unmap, and with a growth policy trim the file to the logical length.
+    errno_t close() noexcept {
+        errno_t en = kEnoOk;
+        if (m_growth.kind != GrowthKind::kNone && m_size < capacity() &&
+            !m_file.isAnon() && !_isPrivateFile()) {
+            // an empty view cannot be mapped, so trim through the handle
+            auto const file_sz = size_type(m_file.fileOffset()) + m_size;
+            auto const handle = traits_type::dupHandle(m_file.fileHandle());
+            en = m_file.unmap();
+            if (traits_type::checkHandle(handle)) {
+                if (!traits_type::fileResize(handle, file_sz) && !en) { en = file_type::_throwErrno(false); }
+                traits_type::fileClose(handle);
+            }
+        }
+        if (auto en_unmap = m_file.unmap(); !en) { en = en_unmap; }
+        m_pos  = 0;
+        m_size = 0;
+        clearDirty();
+        _resetTracking();
+        return en;
+    }
+
+    GrowthPolicy const & growthPolicy() const noexcept { return m_growth; }
+    void setGrowthPolicy(GrowthPolicy policy) noexcept { m_growth = policy; }
+
+    StreamingPolicy const & streamingPolicy() const noexcept { return m_streaming; }
+    void setStreamingPolicy(StreamingPolicy policy) noexcept {
+        m_streaming = policy;
+        _resetTracking();
+        _track();
+    }
+
+    // Set the logical length, e.g. to 0 before writing a fresh file.
+    void truncate(size_type length) noexcept {
+        m_size = std::min(length, capacity());
+        m_pos  = std::min(m_pos, m_size);
+    }
+
+    /**
+     * Make `length` bytes from the position writable, growing per the
+     * policy if needed. Return false if they do not fit.
+     */
+    bool reserve(size_type length) noexcept {
+        if (m_pos <= capacity() && capacity() - m_pos >= length) { return true; }
+        return _grow(m_pos + length);
     }
 
     bool isEOF() const noexcept { return m_pos >= size(); }
-    size_type size() const noexcept { return m_file.size(); }
+    size_type size() const noexcept { return m_size; }
+    size_type capacity() const noexcept { return m_file.size(); }
     size_type tell() const noexcept { return m_pos; }
     size_type remaining() const noexcept { return tell() < size() ? size() - tell() : 0; }
 
     size_type seek(off_type offset, BufferPos whence = BufferPos::kCur) noexcept {
         m_pos = _getPos(offset, whence);
+        if (m_pos < m_dropped) [[unlikely]] { _resetTracking(); }
+        _track();
         return m_pos;
     }
 
-    bool flush() noexcept { return m_file.flush() == kEnoOk; }
+    bool flush() noexcept {
+        if (m_file.flush() != kEnoOk) { return false; }
+        clearDirty();
+        return true;
+    }
+
+    /**
+     * Sync only the pages written since the last flush.
+     * Ranges that failed to sync stay dirty.
+     */
+    bool flushDirty(bool b_async = false) noexcept {
+        if (m_b_all_dirty) [[unlikely]] { return flush(); }
+        auto const page_size = _pageSize();
+        for (auto iter = m_dirty.begin(); iter != m_dirty.end();) {
+            auto const offset = iter->first * page_size;
+            auto const length = (iter->second - iter->first) * page_size;
+            if (offset < capacity() && m_file.sync(offset, length, b_async) != kEnoOk) { return false; }
+            iter = m_dirty.erase(iter);
+        }
+        return true;
+    }
+
+    bool isDirty() const noexcept { return m_b_all_dirty || !m_dirty.empty(); }
+    /**
+     * Dirty page index ranges `[beg, end)` of the buffer. If tracking ran
+     * out of memory, the set is empty and every page counts as dirty.
+     */
+    dirty_set_type const & dirtyPages() const noexcept { return m_dirty; }
+    void clearDirty() noexcept {
+        m_dirty.clear();
+        m_b_all_dirty = false;
+    }
 
     size_type read(pointer data, size_type length = npos) noexcept {
         assert(data);
@@ -78,6 +219,7 @@ public:
         if (size() - m_pos < length) { length = size() - m_pos; }
         std::memcpy(data, m_file.data() + m_pos, length);
         m_pos += length;
+        _track();
         return length;
     }
 
@@ -87,6 +229,7 @@ public:
             return 0;
         }
         data = m_file.data()[m_pos++];
+        _track();
         return 1;
     }
 
@@ -95,41 +238,114 @@ public:
         if (size() - m_pos < length) { length = size() - m_pos; }
         auto p = m_file.data() + m_pos;
         m_pos += length;
+        _track();
         return view_type{p, length};
     }
 
     view_type readline(byte_type sep = '\n') noexcept {
         if (isEOF()) [[unlikely]] { return view_type{}; }
-        size_type length = 0;
         auto p = m_file.data() + m_pos;
         auto const max_len = size() - m_pos;
-        while (length < max_len) {
-            if (*(p + length) == sep) {
-                ++length;
-                break;
-            }
-            ++length;
-        }
+        auto found = detail::findByte<byte_type>(p, max_len, sep);
+        size_type length = found ? size_type(found - p) + 1 : max_len;
         m_pos += length;
+        _track();
         return view_type{p, length};
     }
 
+    /**
+     * Read up to `max_count` lines into `out`, return how many were read.
+     * Separators are located a block at a time, so short lines cost far
+     * less than one `readline` each.
+     */
+    size_type readlines(view_type * out, size_type max_count, byte_type sep = '\n') noexcept {
+        constexpr size_type kBatch = 256;
+        size_type offsets[kBatch];
+        size_type count = 0;
+        while (count < max_count && !isEOF()) {
+            auto p = m_file.data() + m_pos;
+            auto const max_len = size() - m_pos;
+            auto const want = std::min(kBatch, max_count - count);
+            auto const found = detail::findEach(reinterpret_cast<char const *>(p), max_len,
+                static_cast<char>(sep), offsets, want);
+            size_type beg = 0;
+            for (size_type i = 0; i < found; ++i) {
+                out[count++] = view_type{p + beg, offsets[i] + 1 - beg};
+                beg = offsets[i] + 1;
+            }
+            if (found < want) {
+                // no separator left, the tail is the last line
+                if (beg < max_len) { out[count++] = view_type{p + beg, max_len - beg}; }
+                beg = max_len;
+            }
+            m_pos += beg;
+        }
+        _track();
+        return count;
+    }
+
+    // Lines from the current position on, the position is not moved.
+    line_range_type lines(byte_type sep = '\n') const noexcept {
+        if (isEOF()) { return line_range_type{}; }
+        return line_range_type{view_type{m_file.data() + m_pos, size() - m_pos}, sep};
+    }
+
+    /**
+     * Typed view at byte `offset`, see `file_type::view`. The mutable view
+     * marks its whole range dirty since writes through it are not tracked.
+     */
+    template <MMapViewable T>
+    MMapSpan<T> view(size_type offset, size_type count = file_type::kInvalidSize) noexcept {
+        auto sp = m_file.template view<T>(offset, count);
+        _markDirty(offset, sp.size_bytes());
+        return sp;
+    }
+    template <MMapViewable T>
+    MMapSpan<T const> view(size_type offset, size_type count = file_type::kInvalidSize) const noexcept {
+        return m_file.template view<T>(offset, count);
+    }
+
+    // Typed view of `count` elements at the current position, consumed on success.
+    template <MMapViewable T>
+    MMapSpan<T const> readSpan(size_type count) noexcept {
+        if (count > remaining() / sizeof(T)) [[unlikely]] { return {}; }
+        auto sp = std::as_const(m_file).template view<T>(m_pos, count);
+        m_pos += sp.size_bytes();
+        _track();
+        return sp;
+    }
+
+    // Writable typed view of `count` elements at the current position, consumed on success.
+    template <MMapViewable T>
+    MMapSpan<T> writeSpan(size_type count) noexcept {
+        if (count != file_type::kInvalidSize && !reserve(count * sizeof(T))) [[unlikely]] { return {}; }
+        auto sp = m_file.template view<T>(m_pos, count);
+        _markDirty(m_pos, sp.size_bytes());
+        _advance(sp.size_bytes());
+        return sp;
+    }
+
     size_type _write(const_pointer data, size_type length) noexcept {
         assert(data);
         std::memcpy(m_file.data() + m_pos, data, length);
-        m_pos += length;
+        _markDirty(m_pos, length);
+        _advance(length);
         return length;
     }
 
     size_type write(const_pointer data, size_type length) noexcept {
-        if (isEOF()) [[unlikely]] { return 0; }
-        if (size() - m_pos < length) { length = size() - m_pos; }
+        if (!reserve(length)) {
+            if (m_pos >= capacity()) [[unlikely]] { return 0; }
+            length = capacity() - m_pos;
+        }
         return _write(data, length);
     }
 
     size_type writeByte(byte_type byte) noexcept {
-        if (isEOF()) [[unlikely]] { return 0; }
-        m_file.data()[m_pos++] = byte;
+        if (!reserve(1)) [[unlikely]] { return 0; }
+        _markDirty(m_pos, 1);
+        m_file.data()[m_pos] = byte;
+        _advance(1);
         return 1;
     }
 
@@ -139,8 +355,94 @@ public:
 
 private:
     void _move(BasicMMapFileBuf && ot) noexcept {
-        m_file = std::move(ot.m_file);
-        m_pos  = std::exchange(ot.m_pos, 0);
+        m_file   = std::move(ot.m_file);
+        m_pos    = std::exchange(ot.m_pos, 0);
+        m_size   = std::exchange(ot.m_size, 0);
+        m_growth = ot.m_growth;
+        m_dirty  = std::move(ot.m_dirty);
+        m_b_all_dirty = std::exchange(ot.m_b_all_dirty, false);
+        m_streaming   = ot.m_streaming;
+        m_dropped     = std::exchange(ot.m_dropped, 0);
+        m_ahead_end   = std::exchange(ot.m_ahead_end, 0);
+        m_next_advice = std::exchange(ot.m_next_advice, 0);
+    }
+
+    void _advance(size_type length) noexcept {
+        m_pos += length;
+        if (m_pos > m_size) { m_size = m_pos; }
+        _track();
+    }
+
+    void _track() noexcept {
+        if (m_streaming.b_enabled && m_pos >= m_next_advice) [[unlikely]] { _adviseAround(); }
+    }
+
+    void _resetTracking() noexcept {
+        m_dropped = m_ahead_end = m_next_advice = 0;
+    }
+
+    // Read ahead of the cursor and drop what it left behind, a step at a time.
+    void _adviseAround() noexcept {
+        m_next_advice = m_pos + std::max<size_type>(m_streaming.step, 1);
+        if (!m_file.isMapped() || m_file.isAnon()) { return; }
+        auto const page_size = _pageSize();
+        auto const ahead_end = std::min(capacity(), m_pos + m_streaming.read_ahead);
+        auto const ahead_beg = std::max(m_ahead_end, m_pos & ~(page_size - 1));
+        if (ahead_end > ahead_beg) {
+            m_file.advise(AdviceFlag::kWillNeed, ahead_beg, ahead_end - ahead_beg);
+            m_ahead_end = ahead_end;
+        }
+        if (m_pos <= m_streaming.keep_behind) { return; }
+        auto const behind_end = (m_pos - m_streaming.keep_behind) & ~(page_size - 1);
+        if (behind_end <= m_dropped) { return; }
+        auto const length = behind_end - m_dropped;
+        // dropped pages of a private mapping lose their writes, those of a
+        // shared one stay in the page cache until written back
+        if (!_isPrivateFile()) { m_file.advise(AdviceFlag::kDontNeed, m_dropped, length); }
+        m_file.fileAdvise(AdviceFlag::kDontNeed, m_dropped, length);
+        m_dropped = behind_end;
+    }
+
+    bool _grow(size_type required) noexcept {
+        if (m_growth.kind == GrowthKind::kNone || !m_file.isMapped()) { return false; }
+        if (_isPrivateFile()) [[unlikely]] { return false; }
+        if (required > m_growth.max_size) [[unlikely]] { return false; }
+        auto const cap = capacity();
+        auto new_cap = required;
+        if (m_growth.kind == GrowthKind::kGeometric) {
+            new_cap = std::max(new_cap, size_type(double(cap) * m_growth.factor));
+        } else if (m_growth.step) {
+            new_cap = cap + (required - cap + m_growth.step - 1) / m_growth.step * m_growth.step;
+        }
+        auto const page_size = _pageSize();
+        new_cap = std::min((new_cap + page_size - 1) & ~(page_size - 1), size_type(m_growth.max_size));
+        if (auto en = m_file.resize(new_cap)) {
+            AYMMAP_DEBUG("Failed to grow the buffer: ", en);
+            return false;
+        }
+        return true;
+    }
+
+    bool _isPrivateFile() const noexcept {
+        return m_file.isMapped() && !m_file.isAnon() && bool(m_file.accessFlag() & AccessFlag::kCopy);
+    }
+
+    static size_type _pageSize() noexcept {
+        static auto const s_page_size = static_cast<size_type>(file_type::pageSize());
+        return s_page_size;
+    }
+
+    // Called from `noexcept` writers: without memory for the set, fall back
+    // to the whole buffer being dirty.
+    void _markDirty(size_type pos, size_type length) noexcept {
+        if (length == 0 || m_b_all_dirty) [[unlikely]] { return; }
+        auto const page_size = _pageSize();
+        try {
+            m_dirty.add(pos / page_size, (pos + length + page_size - 1) / page_size);
+        } catch (...) {
+            m_dirty.clear();
+            m_b_all_dirty = true;
+        }
     }
 
     size_type _getPos(off_type offset, BufferPos whence) noexcept {
@@ -171,6 +473,16 @@ private:
 private:
     file_type m_file;
     size_type m_pos = 0;
+    size_type m_size = 0;
+    GrowthPolicy   m_growth;
+    dirty_set_type m_dirty;
+    bool           m_b_all_dirty = false;
+
+    StreamingPolicy m_streaming;
+    // file bytes before this were dropped, and read ahead up to `m_ahead_end`
+    size_type m_dropped = 0;
+    size_type m_ahead_end = 0;
+    size_type m_next_advice = 0;
 };
 using MMapFileBuf = BasicMMapFileBuf<MMapFile>;
 }
@@ -21,12 +21,21 @@
 #error unreachable
 #endif
 
+#include <algorithm>
+#include <array>
 #include <cstdio>
 #include <cerrno>
+#include <utility>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/resource.h>
+#include <sched.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
 
 #include "aymmap/file/mman.hpp"
 
@@ -62,6 +71,9 @@ struct MemMapData {
     void *      p_data_      = nullptr;
     size_type   length_{};
     off_type    offset_{};
+    size_type   page_size_{};
+    size_type   reserved_{};
+    AccessFlag  access_{};
 
     MemMapData() = default;
     ~MemMapData() = default;
@@ -71,6 +83,9 @@ struct MemMapData {
         p_data_ = std::exchange(ot.p_data_, nullptr);
         length_ = std::exchange(ot.length_, 0);
         offset_ = std::exchange(ot.offset_, 0);
+        page_size_ = std::exchange(ot.page_size_, 0);
+        reserved_ = std::exchange(ot.reserved_, 0);
+        access_ = std::exchange(ot.access_, AccessFlag{});
         return *this;
     }
 
@@ -88,6 +103,43 @@ MemMapTraits::off_type MemMapTraits::pageSize() {
     return static_cast<off_type>(::sysconf(_SC_PAGE_SIZE));
 }
 
+namespace detail {
+inline MemMapData::size_type _readSysValue(char const * path, char const * fmt) {
+    MemMapData::size_type val{};
+    auto * fi = std::fopen(path, "r");
+    if (!fi) { return 0U; }
+    char line[128];
+    while (std::fgets(line, sizeof(line), fi)) {
+        if (std::sscanf(line, fmt, &val) == 1) { break; }
+    }
+    std::fclose(fi);
+    return val;
+}
+
+inline MemMapData::size_type _roundUp(MemMapData::size_type n, MemMapData::size_type align) {
+    return (n + align - 1) & ~(align - 1);
+}
+}
+
+/**
+ * Page size used by the huge page options of the access flag.
+ * Explicit sizes win, `kHugeTLB` alone uses the default hugetlbfs size and
+ * anything else yields the transparent huge page size.
+ */
+template <>
+MemMapTraits::size_type MemMapTraits::hugePageSize(AccessFlag access) {
+    constexpr size_type kSize2MB = size_type(1) << 21;
+    if ((access & AccessFlag::kHugeTLB1GB) == AccessFlag::kHugeTLB1GB) { return size_type(1) << 30; }
+    if ((access & AccessFlag::kHugeTLB2MB) == AccessFlag::kHugeTLB2MB) { return kSize2MB; }
+    if (bool(access & AccessFlag::_kHugeTLB)) {
+        static size_type const s_size = detail::_readSysValue("/proc/meminfo", "Hugepagesize: %zu kB") << 10;
+        return s_size ? s_size : kSize2MB;
+    }
+    static size_type const s_thp_size = detail::_readSysValue(
+        "/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "%zu");
+    return s_thp_size ? s_thp_size : kSize2MB;
+}
+
 template <>
 bool MemMapTraits::checkHandle(handle_type handle) {
     return (handle != kInvalidHandle);
@@ -115,6 +167,108 @@ MemMapTraits::handle_type MemMapTraits::fileOpen(path_cref ph, AccessFlag access
     return ::open(ph.c_str(), mode, 0777);
 }
 
+/**
+ * Anonymous memory-backed file, the name is only shown in `/proc`.
+ * Sealing is allowed, huge page options back it with hugetlbfs pages.
+ * [memfd_create(2)](http://man7.org/linux/man-pages/man2/memfd_create.2.html)
+ */
+template <>
+MemMapTraits::handle_type MemMapTraits::memFileCreate(
+    [[maybe_unused]] char const * name, [[maybe_unused]] AccessFlag access) {
+#ifdef MFD_CLOEXEC
+    unsigned flags = MFD_CLOEXEC | MFD_ALLOW_SEALING;
+#ifdef MFD_HUGETLB
+    if (bool(access & AccessFlag::_kHugeTLB)) {
+        flags |= MFD_HUGETLB;
+        // `MFD_HUGE_*` share the `MAP_HUGE_*` encoding
+#ifdef MAP_HUGE_SHIFT
+        if ((access & AccessFlag::kHugeTLB1GB) == AccessFlag::kHugeTLB1GB) {
+            flags |= 30U << MAP_HUGE_SHIFT;
+        } else if ((access & AccessFlag::kHugeTLB2MB) == AccessFlag::kHugeTLB2MB) {
+            flags |= 21U << MAP_HUGE_SHIFT;
+        }
+#endif
+    }
+#endif
+    return ::memfd_create(name, flags);
+#else
+    errno = ENOSYS;
+    return kInvalidHandle;
+#endif
+}
+
+/**
+ * Open a named POSIX shared memory object, the name starts with a slash.
+ * [shm_open(3)](http://man7.org/linux/man-pages/man3/shm_open.3.html)
+ */
+template <>
+MemMapTraits::handle_type MemMapTraits::shmOpen(char const * name, AccessFlag access) {
+    int mode = bool(access & AccessFlag::_kWrite) ? O_RDWR : O_RDONLY;
+    if (bool(access & AccessFlag::kCreate)) { mode |= O_CREAT; }
+    return ::shm_open(name, mode, 0600);
+}
+
+template <>
+bool MemMapTraits::shmUnlink(char const * name) {
+    return ::shm_unlink(name) == 0;
+}
+
+namespace detail {
+#ifdef F_ADD_SEALS
+inline constexpr std::array<std::pair<SealFlag, int>, 5> kSealMap{{
+    {SealFlag::kSeal,   F_SEAL_SEAL},
+    {SealFlag::kShrink, F_SEAL_SHRINK},
+    {SealFlag::kGrow,   F_SEAL_GROW},
+    {SealFlag::kWrite,  F_SEAL_WRITE},
+#ifdef F_SEAL_FUTURE_WRITE
+    {SealFlag::kFutureWrite, F_SEAL_FUTURE_WRITE},
+#else
+    {SealFlag::kFutureWrite, 0},
+#endif
+}};
+#endif
+}
+
+/**
+ * Add seals to a memory file. `kWrite` fails while writable shared
+ * mappings exist, `kFutureWrite` only blocks new ones.
+ * [fcntl(2)](http://man7.org/linux/man-pages/man2/fcntl.2.html)
+ */
+template <>
+bool MemMapTraits::fileSeal([[maybe_unused]] handle_type handle, [[maybe_unused]] SealFlag seal) {
+#ifdef F_ADD_SEALS
+    int seals{};
+    for (auto [flag, native] : detail::kSealMap) {
+        if (!bool(seal & flag)) { continue; }
+        if (native == 0) {
+            errno = EINVAL;
+            return false;
+        }
+        seals |= native;
+    }
+    return ::fcntl(handle, F_ADD_SEALS, seals) == 0;
+#else
+    errno = ENOSYS;
+    return false;
+#endif
+}
+
+template <>
+bool MemMapTraits::fileSeals([[maybe_unused]] handle_type handle, SealFlag & seal) {
+    seal = SealFlag::kNone;
+#ifdef F_GET_SEALS
+    int const seals = ::fcntl(handle, F_GET_SEALS);
+    if (seals == -1) { return false; }
+    for (auto [flag, native] : detail::kSealMap) {
+        if (native && (seals & native)) { seal = seal | flag; }
+    }
+    return true;
+#else
+    errno = ENOSYS;
+    return false;
+#endif
+}
+
 template <>
 bool MemMapTraits::fileClose(handle_type handle) {
     return ::close(handle) == 0;
@@ -126,50 +280,277 @@ bool MemMapTraits::fileResize(handle_type handle, size_type new_size) {
 }
 
 /**
- * [mmap(2)](http://man7.org/linux/man-pages/man2/mmap.2.html)
+ * Allocate the file blocks of a range, growing the file if needed, so
+ * later writes through a mapping cannot fail for lack of space.
+ * [posix_fallocate(3)](http://man7.org/linux/man-pages/man3/posix_fallocate.3.html)
  */
 template <>
-bool MemMapTraits::map(data_type & d, AccessFlag access, size_type length, off_type offset) {
-    int prot{};
-    int flags{};
+bool MemMapTraits::fileAllocate(handle_type handle, off_type offset, size_type length) {
+    if (auto en = ::posix_fallocate(handle, offset, static_cast<off_t>(length))) {
+        errno = en;
+        return false;
+    }
+    return true;
+}
+
+template <>
+bool MemMapTraits::fileSync(handle_type handle) {
+    return ::fdatasync(handle) == 0;
+}
+
+/**
+ * Page cache advice on a file range, only the advices with a
+ * `POSIX_FADV_*` counterpart are accepted.
+ * [posix_fadvise(2)](http://man7.org/linux/man-pages/man2/posix_fadvise.2.html)
+ */
+template <>
+bool MemMapTraits::fileAdvise(handle_type handle,
+    off_type offset, size_type length, AdviceFlag adv_flag) {
+    int flag{};
+    switch (adv_flag) {
+        case AdviceFlag::kNormal: flag = POSIX_FADV_NORMAL; break;
+        case AdviceFlag::kRandom: flag = POSIX_FADV_RANDOM; break;
+        case AdviceFlag::kSequential: flag = POSIX_FADV_SEQUENTIAL; break;
+        case AdviceFlag::kWillNeed: flag = POSIX_FADV_WILLNEED; break;
+        case AdviceFlag::kDontNeed: flag = POSIX_FADV_DONTNEED; break;
+        default:
+            errno = EINVAL;
+            return false;
+    }
+    if (auto en = ::posix_fadvise(handle, offset, static_cast<off_type>(length), flag)) {
+        errno = en;
+        return false;
+    }
+    return true;
+}
 
+namespace detail {
+inline int _mapProt(AccessFlag access) noexcept {
+    int prot{};
     if (bool(access & AccessFlag::kRead)) { prot |= PROT_READ; }
     if (bool(access & AccessFlag::_kWrite)) { prot |= PROT_WRITE; }
     if (bool(access & AccessFlag::kExec)) { prot |= PROT_EXEC; }
-    flags = bool(access & AccessFlag::kCopy) ? MAP_PRIVATE : MAP_SHARED;
+    return prot;
+}
+
+inline int _mapFlags(MemMapData const & d, AccessFlag access) noexcept {
+    int flags = bool(access & AccessFlag::kCopy) ? MAP_PRIVATE : MAP_SHARED;
     if (d.file_handle_ == kInvalidHandle) { flags |= MAP_ANONYMOUS; }
+    return flags;
+}
+
+inline int _hugeTLBFlags([[maybe_unused]] AccessFlag access) {
+    int flags{};
+#ifdef MAP_HUGETLB
+    flags |= MAP_HUGETLB;
+#ifdef MAP_HUGE_SHIFT
+    if ((access & AccessFlag::kHugeTLB1GB) == AccessFlag::kHugeTLB1GB) {
+        flags |= 30 << MAP_HUGE_SHIFT;
+    } else if ((access & AccessFlag::kHugeTLB2MB) == AccessFlag::kHugeTLB2MB) {
+        flags |= 21 << MAP_HUGE_SHIFT;
+    }
+#endif
+#endif
+    return flags;
+}
+
+/**
+ * Map at an address aligned to `align` by over-reserving the range and
+ * trimming the unused head and tail. Up to `reserved` bytes of address
+ * space behind the base are kept as an inaccessible reservation.
+ */
+inline void * _mmapAligned(MemMapData::size_type length, int prot, int flags,
+    int fd, MemMapData::off_type offset, MemMapData::size_type align,
+    MemMapData::size_type reserved = 0) {
+    auto const page_size = static_cast<MemMapData::size_type>(::sysconf(_SC_PAGE_SIZE));
+    if (align < page_size) { align = page_size; }
+    if (align == page_size && reserved <= length) {
+        return ::mmap(NULL, length, prot, flags, fd, offset);
+    }
+
+    auto const kept_length = _roundUp(std::max(length, reserved), page_size);
+    auto const reserved_length = kept_length + align - page_size;
+    void * p_reserved = ::mmap(NULL, reserved_length, PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (p_reserved == MAP_FAILED) { return MAP_FAILED; }
+
+    auto const beg = reinterpret_cast<std::uintptr_t>(p_reserved);
+    auto const aligned_beg = _roundUp(beg, align);
+    void * p_map = ::mmap(reinterpret_cast<void *>(aligned_beg), length, prot,
+        flags | MAP_FIXED, fd, offset);
+    if (p_map == MAP_FAILED) {
+        auto en = errno;
+        ::munmap(p_reserved, reserved_length);
+        errno = en;
+        return MAP_FAILED;
+    }
+
+    auto const aligned_end = aligned_beg + kept_length;
+    auto const end = beg + reserved_length;
+    if (aligned_beg > beg) { ::munmap(p_reserved, aligned_beg - beg); }
+    if (end > aligned_end) { ::munmap(reinterpret_cast<void *>(aligned_end), end - aligned_end); }
+    return p_map;
+}
 
-    void * p_map = ::mmap(NULL, length, prot, flags, d.file_handle_, offset);
+inline MemMapData::size_type _mappedLength(MemMapData const & d, MemMapData::size_type length) {
+    if (bool(d.access_ & AccessFlag::_kHugeTLB)) { return _roundUp(length, d.page_size_); }
+    return length;
+}
+
+/**
+ * Grow or shrink a view in place inside its address space reservation.
+ * New extents are mapped behind the last mapped page, released pages
+ * return to the inaccessible reservation.
+ */
+inline bool _remapReserved(MemMapData & d, MemMapData::size_type new_length) {
+    auto const page_size = static_cast<MemMapData::size_type>(::sysconf(_SC_PAGE_SIZE));
+    auto * const p_beg = static_cast<char *>(d.p_data_);
+    auto const old_end = _roundUp(d.length_, page_size);
+    auto const new_end = _roundUp(new_length, page_size);
+    if (new_end > old_end) {
+        void * p_map = ::mmap(p_beg + old_end, new_length - old_end, _mapProt(d.access_),
+            _mapFlags(d, d.access_) | MAP_FIXED, d.file_handle_,
+            d.offset_ + static_cast<MemMapData::off_type>(old_end));
+        if (p_map == MAP_FAILED) { return false; }
+    } else if (new_end < old_end) {
+        void * p_map = ::mmap(p_beg + new_end, old_end - new_end, PROT_NONE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+        if (p_map == MAP_FAILED) { return false; }
+    }
+    d.length_ = new_length;
+    return true;
+}
+}
+
+/**
+ * [mmap(2)](http://man7.org/linux/man-pages/man2/mmap.2.html)
+ *
+ * `kHugeTLB` falls back to normal pages when no huge page is reserved,
+ * `kTransHuge` is dropped from `access_` when the kernel rejects the advice.
+ * `page_size_` records the page size actually backing the mapping.
+ *
+ * A non-zero `reserved_` reserves that much address space for the view,
+ * `remap` then grows and shrinks it without moving the base address.
+ */
+template <>
+bool MemMapTraits::map(data_type & d, AccessFlag access, size_type length, off_type offset) {
+    int const prot = detail::_mapProt(access);
+    int flags = detail::_mapFlags(d, access);
+#ifdef MAP_POPULATE
+    if (bool(access & AccessFlag::kPopulate)) { flags |= MAP_POPULATE; }
+#endif
+
+    void * p_map = MAP_FAILED;
+    size_type page_size = static_cast<size_type>(pageSize());
+
+    if (d.reserved_) {
+        if (d.reserved_ < length) [[unlikely]] {
+            errno = EINVAL;
+            return false;
+        }
+        // huge pages cannot grow extent by extent
+        access = access & ~AccessFlag::kHugeTLB1GB & ~AccessFlag::kHugeTLB2MB;
+    }
+
+    if (bool(access & AccessFlag::_kHugeTLB)) {
+#ifdef MAP_HUGETLB
+        p_map = ::mmap(NULL, length, prot, flags | detail::_hugeTLBFlags(access),
+            d.file_handle_, offset);
+#endif
+        if (p_map != MAP_FAILED) {
+            page_size = hugePageSize(access);
+        } else {
+            AYMMAP_DEBUG("Huge page mapping failed, fall back to normal pages.");
+            access = access & ~AccessFlag::kHugeTLB1GB & ~AccessFlag::kHugeTLB2MB;
+        }
+    }
+
+    if (p_map == MAP_FAILED) {
+        size_type align = bool(access & AccessFlag::kAlignHuge) ? hugePageSize(access) : 0;
+        p_map = detail::_mmapAligned(length, prot, flags, d.file_handle_, offset,
+            align, d.reserved_);
+        if (p_map == MAP_FAILED) { return false; }
+
+        if (bool(access & AccessFlag::kTransHuge)) {
+#ifdef MADV_HUGEPAGE
+            if (::madvise(p_map, length, MADV_HUGEPAGE) != -1) {
+                page_size = hugePageSize(access);
+            } else
+#endif
+            {
+                AYMMAP_DEBUG("Transparent huge page is unavailable.");
+                access = access & ~AccessFlag::kTransHuge;
+            }
+        }
+    }
+
+    d.p_data_ = p_map;
+    d.length_ = length;
+    d.offset_ = offset;
+    d.page_size_ = page_size;
+    d.access_ = access;
+    return true;
+}
+
+/**
+ * Map at exactly `addr`, atomically replacing whatever is mapped there,
+ * e.g. the previous view of `d` when sliding it over the file.
+ * Huge page options are ignored. On failure the old mapping at `addr`
+ * may be gone.
+ */
+template <>
+bool MemMapTraits::mapFixed(data_type & d, void * addr,
+    AccessFlag access, size_type length, off_type offset) {
+    access = access & ~AccessFlag::kHugeTLB1GB & ~AccessFlag::kHugeTLB2MB
+                    & ~AccessFlag::kTransHuge & ~AccessFlag::kAlignHuge;
+    int flags = detail::_mapFlags(d, access) | MAP_FIXED;
+#ifdef MAP_POPULATE
+    if (bool(access & AccessFlag::kPopulate)) { flags |= MAP_POPULATE; }
+#endif
+    void * p_map = ::mmap(addr, length, detail::_mapProt(access), flags, d.file_handle_, offset);
     if (p_map == MAP_FAILED) { return false; }
     d.p_data_ = p_map;
     d.length_ = length;
     d.offset_ = offset;
+    d.page_size_ = static_cast<size_type>(pageSize());
+    d.access_ = access;
     return true;
 }
 
 template <>
 bool MemMapTraits::unmap(data_type & d) {
     if (d.p_data_) [[likely]] {
-        if (::munmap(d.p_data_, d.length_) == -1) { return false; }
+        auto const length = std::max(detail::_mappedLength(d, d.length_), d.reserved_);
+        if (::munmap(d.p_data_, length) == -1) { return false; }
     }
     d.p_data_ = nullptr;
     d.length_ = 0;
     d.offset_ = 0;
+    d.page_size_ = 0;
+    d.reserved_ = 0;
+    d.access_ = AccessFlag{};
     return true;
 }
 
 template <>
 bool MemMapTraits::remap(data_type & d, size_type new_length) {
+    if (d.reserved_ && new_length > d.reserved_) [[unlikely]] {
+        errno = ENOMEM;
+        return false;
+    }
     auto const new_file_sz = size_type(d.offset_) + new_length;
     if (d.file_handle_ != kInvalidHandle && !fileResize(d.file_handle_, new_file_sz)) {
         return false;
     }
+    if (d.reserved_) { return detail::_remapReserved(d, new_length); }
 
+    auto const old_mapped_length = detail::_mappedLength(d, d.length_);
+    auto const new_mapped_length = detail::_mappedLength(d, new_length);
     void * p_new_data = nullptr;
 #ifdef MREMAP_MAYMOVE
-    p_new_data = ::mremap(d.p_data_, d.length_, new_length, MREMAP_MAYMOVE);
+    p_new_data = ::mremap(d.p_data_, old_mapped_length, new_mapped_length, MREMAP_MAYMOVE);
 #else
-    p_new_data = ::mremap(d.p_data_, d.length_, new_length, 0);
+    p_new_data = ::mremap(d.p_data_, old_mapped_length, new_mapped_length, 0);
 #endif
     if (p_new_data == MAP_FAILED) { return false; }
     d.p_data_ = p_new_data;
@@ -182,11 +563,43 @@ bool MemMapTraits::sync(void * addr, size_type length) {
     return ::msync(addr, length, MS_SYNC) != -1;
 }
 
+template <>
+bool MemMapTraits::syncAsync(void * addr, size_type length) {
+    return ::msync(addr, length, MS_ASYNC) != -1;
+}
+
+/**
+ * Start write-back of the dirty pages in the file range without waiting.
+ * [sync_file_range(2)](http://man7.org/linux/man-pages/man2/sync_file_range.2.html)
+ */
+template <>
+bool MemMapTraits::writeBack(handle_type handle, off_type offset, size_type length) {
+#ifdef SYNC_FILE_RANGE_WRITE
+    return ::sync_file_range(handle, offset, static_cast<off_type>(length), SYNC_FILE_RANGE_WRITE) != -1;
+#else
+    errno = ENOSYS;
+    return false;
+#endif
+}
+
 template <>
 bool MemMapTraits::lock(void * addr, size_type length) {
     return ::mlock(addr, length) != -1;
 }
 
+/**
+ * [mlock2(2)](http://man7.org/linux/man-pages/man2/mlock2.2.html)
+ */
+template <>
+bool MemMapTraits::lockOnFault(void * addr, size_type length) {
+#ifdef MLOCK_ONFAULT
+    return ::mlock2(addr, length, MLOCK_ONFAULT) != -1;
+#else
+    errno = ENOSYS;
+    return false;
+#endif
+}
+
 template <>
 bool MemMapTraits::unlock(void * addr, size_type length) {
     return ::munlock(addr, length) != -1;
@@ -210,21 +623,135 @@ bool MemMapTraits::protect(void * addr, size_type length, AccessFlag access) {
     return ::mprotect(addr, length, prot) != -1;
 }
 
+namespace detail {
+/**
+ * Native advice of `AdviceFlag`, `-1` if the headers do not provide it.
+ */
+inline int _nativeAdvice(AdviceFlag adv_flag) noexcept {
+    switch (adv_flag) {
+        case AdviceFlag::kNormal: return MADV_NORMAL;
+        case AdviceFlag::kRandom: return MADV_RANDOM;
+        case AdviceFlag::kSequential: return MADV_SEQUENTIAL;
+        case AdviceFlag::kWillNeed: return MADV_WILLNEED;
+        case AdviceFlag::kDontNeed: return MADV_DONTNEED;
+#ifdef MADV_FREE
+        case AdviceFlag::kFree: return MADV_FREE;
+#endif
+#ifdef MADV_COLD
+        case AdviceFlag::kCold: return MADV_COLD;
+#endif
+#ifdef MADV_PAGEOUT
+        case AdviceFlag::kPageOut: return MADV_PAGEOUT;
+#endif
+#ifdef MADV_HUGEPAGE
+        case AdviceFlag::kHugePage: return MADV_HUGEPAGE;
+        case AdviceFlag::kNoHugePage: return MADV_NOHUGEPAGE;
+#endif
+#ifdef MADV_MERGEABLE
+        case AdviceFlag::kMergeable: return MADV_MERGEABLE;
+        case AdviceFlag::kUnmergeable: return MADV_UNMERGEABLE;
+#endif
+#ifdef MADV_POPULATE_READ
+        case AdviceFlag::kPopulateRead: return MADV_POPULATE_READ;
+        case AdviceFlag::kPopulateWrite: return MADV_POPULATE_WRITE;
+#endif
+#ifdef MADV_DONTFORK
+        case AdviceFlag::kDontFork: return MADV_DONTFORK;
+        case AdviceFlag::kDoFork: return MADV_DOFORK;
+#endif
+#ifdef MADV_DONTDUMP
+        case AdviceFlag::kDontDump: return MADV_DONTDUMP;
+        case AdviceFlag::kDoDump: return MADV_DODUMP;
+#endif
+        default: return -1;
+    }
+}
+}
+
 /**
  * [madvise(2)](http://man7.org/linux/man-pages/man2/madvise.2.html)
  */
 template <>
 bool MemMapTraits::advise(void * addr, size_type length, AdviceFlag adv_flag) {
-    int flag{};
-    switch (adv_flag) {
-        case AdviceFlag::kNormal: flag = MADV_NORMAL;
-        case AdviceFlag::kRandom: flag = MADV_RANDOM;
-        case AdviceFlag::kSequential: flag = MADV_SEQUENTIAL;
-        case AdviceFlag::kWillNeed: flag = MADV_WILLNEED;
-        case AdviceFlag::kDontNeed: flag = MADV_DONTNEED;
-        default: return false;
+    int flag = detail::_nativeAdvice(adv_flag);
+    if (flag == -1) {
+        errno = EINVAL;
+        return false;
     }
     return ::madvise(addr, length, flag) != -1;
 }
+
+/**
+ * Whether both the headers and the running kernel know the advice.
+ * Every advice is probed once on a scratch anonymous page, kernels reject
+ * unknown advices (and disabled features like KSM or THP) with `EINVAL`.
+ */
+template <>
+bool MemMapTraits::isAdviceSupported(AdviceFlag adv_flag) {
+    constexpr auto kCount = static_cast<std::size_t>(AdviceFlag::_kCount);
+    static auto const s_supported = [] {
+        std::array<bool, kCount> supported{};
+        auto const page_size = static_cast<size_type>(pageSize());
+        void * p_page = ::mmap(NULL, page_size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p_page == MAP_FAILED) { return supported; }
+        for (std::size_t i = 0; i < kCount; ++i) {
+            int flag = detail::_nativeAdvice(static_cast<AdviceFlag>(i));
+            supported[i] = flag != -1 && (::madvise(p_page, page_size, flag) != -1 || errno != EINVAL);
+        }
+        ::munmap(p_page, page_size);
+        return supported;
+    }();
+    auto const i = static_cast<std::size_t>(adv_flag);
+    return i < kCount && s_supported[i];
 }
 
+/**
+ * Prefault the range with `MADV_POPULATE_(READ|WRITE)` (Linux 5.14),
+ * falling back to touching every page on older kernels.
+ */
+template <>
+bool MemMapTraits::populate(void * addr, size_type length, bool b_write) {
+#ifdef MADV_POPULATE_READ
+    if (::madvise(addr, length, b_write ? MADV_POPULATE_WRITE : MADV_POPULATE_READ) != -1) {
+        return true;
+    }
+    if (errno != EINVAL) { return false; }
+#endif
+    detail::_touchPages(addr, length, static_cast<size_type>(pageSize()), b_write);
+    return true;
+}
+
+/**
+ * [getrusage(2)](http://man7.org/linux/man-pages/man2/getrusage.2.html)
+ */
+template <>
+bool MemMapTraits::pageFaults(std::uint64_t & minor, std::uint64_t & major) {
+    struct rusage ru;
+    if (::getrusage(RUSAGE_SELF, &ru) == -1) { return false; }
+    minor = static_cast<std::uint64_t>(ru.ru_minflt);
+    major = static_cast<std::uint64_t>(ru.ru_majflt);
+    return true;
+}
+
+/**
+ * Block while `*addr == expected`. The address may live in a shared mapping,
+ * so waiters in other processes are woken as well.
+ * [futex(2)](http://man7.org/linux/man-pages/man2/futex.2.html)
+ */
+template <>
+void MemMapTraits::waitAddress(std::uint32_t * addr, std::uint32_t expected) {
+#ifdef SYS_futex
+    ::syscall(SYS_futex, addr, FUTEX_WAIT, expected, nullptr, nullptr, 0);
+#else
+    if (__atomic_load_n(addr, __ATOMIC_ACQUIRE) == expected) { ::sched_yield(); }
+#endif
+}
+
+template <>
+void MemMapTraits::wakeAddress([[maybe_unused]] std::uint32_t * addr, [[maybe_unused]] int count) {
+#ifdef SYS_futex
+    ::syscall(SYS_futex, addr, FUTEX_WAKE, count, nullptr, nullptr, 0);
+#endif
+}
+}
@@ -23,6 +23,7 @@
 
 #include <cstdio>
 #include <cstring>
+#include <utility>
 #include <windows.h>
 #include <io.h>
 
@@ -65,6 +66,9 @@ struct MemMapData {
     void *      p_data_      = nullptr;
     size_type   length_{};
     off_type    offset_{};
+    size_type   page_size_{};
+    size_type   reserved_{};
+    AccessFlag  access_{};
 
     MemMapData() = default;
     ~MemMapData() = default;
@@ -75,6 +79,9 @@ struct MemMapData {
         p_data_ = std::exchange(ot.p_data_, nullptr);
         length_ = std::exchange(ot.length_, 0);
         offset_ = std::exchange(ot.offset_, 0);
+        page_size_ = std::exchange(ot.page_size_, 0);
+        reserved_ = std::exchange(ot.reserved_, 0);
+        access_ = std::exchange(ot.access_, AccessFlag{});
         return *this;
     }
 
@@ -100,6 +107,15 @@ MemMapTraits::off_type MemMapTraits::pageSize() {
     return static_cast<off_type>(si.dwAllocationGranularity);
 }
 
+/**
+ * Large pages require `SeLockMemoryPrivilege`, so the huge page options are
+ * ignored by `map` and this only reports the minimum large page size.
+ */
+template <>
+MemMapTraits::size_type MemMapTraits::hugePageSize(AccessFlag) {
+    return static_cast<size_type>(::GetLargePageMinimum());
+}
+
 template <>
 bool MemMapTraits::checkHandle(handle_type handle) {
     return (handle != kInvalidHandle) && (handle != NULL);
@@ -140,6 +156,41 @@ MemMapTraits::handle_type MemMapTraits::fileOpen(path_cref ph, AccessFlag access
                          create_mode, FILE_ATTRIBUTE_NORMAL, 0);
 }
 
+/**
+ * Memory files, named segments and seals have no file handle counterpart,
+ * Windows names the mapping object instead.
+ */
+template <>
+MemMapTraits::handle_type MemMapTraits::memFileCreate(char const *, AccessFlag) {
+    ::SetLastError(ERROR_NOT_SUPPORTED);
+    return kInvalidHandle;
+}
+
+template <>
+MemMapTraits::handle_type MemMapTraits::shmOpen(char const *, AccessFlag) {
+    ::SetLastError(ERROR_NOT_SUPPORTED);
+    return kInvalidHandle;
+}
+
+template <>
+bool MemMapTraits::shmUnlink(char const *) {
+    ::SetLastError(ERROR_NOT_SUPPORTED);
+    return false;
+}
+
+template <>
+bool MemMapTraits::fileSeal(handle_type, SealFlag) {
+    ::SetLastError(ERROR_NOT_SUPPORTED);
+    return false;
+}
+
+template <>
+bool MemMapTraits::fileSeals(handle_type, SealFlag & seal) {
+    seal = SealFlag::kNone;
+    ::SetLastError(ERROR_NOT_SUPPORTED);
+    return false;
+}
+
 template <>
 bool MemMapTraits::fileClose(handle_type handle) {
     return ::CloseHandle(handle);
@@ -155,6 +206,28 @@ bool MemMapTraits::fileResize(handle_type handle, size_type new_size) {
     return ::SetEndOfFile(handle);
 }
 
+template <>
+bool MemMapTraits::fileAllocate(handle_type handle, off_type offset, size_type length) {
+    auto const end = size_type(offset) + length;
+    auto const file_sz = fileSize(handle);
+    if (file_sz < end && !fileResize(handle, end)) { return false; }
+    // a smaller allocation size would truncate the file
+    FILE_ALLOCATION_INFO info;
+    info.AllocationSize.QuadPart = static_cast<LONGLONG>(file_sz > end ? file_sz : end);
+    return ::SetFileInformationByHandle(handle, FileAllocationInfo, &info, sizeof(info));
+}
+
+template <>
+bool MemMapTraits::fileSync(handle_type handle) {
+    return ::FlushFileBuffers(handle);
+}
+
+template <>
+bool MemMapTraits::fileAdvise(handle_type, off_type, size_type, AdviceFlag) {
+    ::SetLastError(ERROR_NOT_SUPPORTED);
+    return false;
+}
+
 namespace detail {
 inline DWORD int64High(auto i) noexcept { return i >> 32; }
 inline DWORD int64Low(auto i) noexcept { return i & 0xffffffff; }
@@ -166,6 +239,12 @@ inline DWORD int64Low(auto i) noexcept { return i & 0xffffffff; }
  */
 template <>
 bool MemMapTraits::map(data_type & d, AccessFlag access, size_type length, off_type offset) {
+    if (d.reserved_) {
+        // growing views in place requires placeholder support
+        ::SetLastError(ERROR_NOT_SUPPORTED);
+        return false;
+    }
+
     DWORD prot{};
 
     if (bool(access & AccessFlag::kCopy)) { prot = PAGE_WRITECOPY; }
@@ -194,6 +273,64 @@ bool MemMapTraits::map(data_type & d, AccessFlag access, size_type length, off_t
     d.map_handle_ = map_handle;
     d.length_     = length;
     d.offset_     = offset;
+    d.page_size_  = static_cast<size_type>(pageSize());
+    d.access_     = access & ~AccessFlag::kHugeTLB1GB & ~AccessFlag::kHugeTLB2MB
+                           & ~AccessFlag::kTransHuge & ~AccessFlag::kAlignHuge;
+    if (bool(access & AccessFlag::kPopulate)) {
+        populate(p_map, length, false);
+    }
+    return true;
+}
+
+/**
+ * https://learn.microsoft.com/en-us/windows/win32/api/memoryapi/nf-memoryapi-mapviewoffileex
+ *
+ * Views cannot be replaced in place, a view of `d` at `addr` is unmapped
+ * first and another thread may take the address in between.
+ */
+template <>
+bool MemMapTraits::mapFixed(data_type & d, void * addr,
+    AccessFlag access, size_type length, off_type offset) {
+    if (d.p_data_ == addr) {
+        if (!::UnmapViewOfFile(d.p_data_)) { return false; }
+        ::CloseHandle(d.map_handle_);
+        d.p_data_     = nullptr;
+        d.map_handle_ = kInvalidHandle;
+    }
+
+    DWORD prot{};
+
+    if (bool(access & AccessFlag::kCopy)) { prot = PAGE_WRITECOPY; }
+    else if (bool(access & AccessFlag::_kWrite)) { prot = PAGE_READWRITE; }
+    else { prot = PAGE_READONLY; }
+    if (bool(access & AccessFlag::kExec)) { prot <<= 4; }
+
+    // the whole file for file views, the view length for anonymous ones
+    size_type const map_size = d.file_handle_ == kInvalidHandle ? length : 0;
+    const auto map_handle = ::CreateFileMappingW(d.file_handle_, 0, prot,
+        detail::int64High(map_size), detail::int64Low(map_size), 0);
+    if (!checkHandle(map_handle)) { return false; }
+
+    if (bool(access & AccessFlag::kCopy)) {
+        prot = FILE_MAP_COPY;
+    } else {
+        prot = bool(access & AccessFlag::_kWrite) ? FILE_MAP_WRITE : FILE_MAP_READ;
+        if (bool(access & AccessFlag::kExec)) { prot |= FILE_MAP_EXECUTE; }
+    }
+
+    void * p_map = ::MapViewOfFileEx(map_handle, prot,
+        detail::int64High(offset), detail::int64Low(offset), length, addr);
+    if (p_map == nullptr) {
+        ::CloseHandle(map_handle);
+        return false;
+    }
+    d.p_data_     = p_map;
+    d.map_handle_ = map_handle;
+    d.length_     = length;
+    d.offset_     = offset;
+    d.page_size_  = static_cast<size_type>(pageSize());
+    d.access_     = access & ~AccessFlag::kHugeTLB1GB & ~AccessFlag::kHugeTLB2MB
+                           & ~AccessFlag::kTransHuge & ~AccessFlag::kAlignHuge;
     return true;
 }
 
@@ -207,6 +344,9 @@ bool MemMapTraits::unmap(data_type & d) {
     d.map_handle_ = kInvalidHandle;
     d.length_     = 0;
     d.offset_     = 0;
+    d.page_size_  = 0;
+    d.reserved_   = 0;
+    d.access_     = AccessFlag{};
     return true;
 }
 
@@ -290,11 +430,28 @@ bool MemMapTraits::sync(void * addr, size_type length) {
     return ::FlushViewOfFile(addr, length);
 }
 
+template <>
+bool MemMapTraits::syncAsync(void * addr, size_type length) {
+    return ::FlushViewOfFile(addr, length);
+}
+
+template <>
+bool MemMapTraits::writeBack(handle_type, off_type, size_type) {
+    ::SetLastError(ERROR_NOT_SUPPORTED);
+    return false;
+}
+
 template <>
 bool MemMapTraits::lock(void * addr, size_type length) {
     return ::VirtualLock(addr, length);
 }
 
+template <>
+bool MemMapTraits::lockOnFault(void *, size_type) {
+    ::SetLastError(ERROR_NOT_SUPPORTED);
+    return false;
+}
+
 template <>
 bool MemMapTraits::unlock(void * addr, size_type length) {
     return ::VirtualUnlock(addr, length);
@@ -319,6 +476,30 @@ bool MemMapTraits::protect(void * addr, size_type length, AccessFlag access) {
 
 template <>
 bool MemMapTraits::advise(void *, size_type, AdviceFlag) { return false; }
+
+template <>
+bool MemMapTraits::isAdviceSupported(AdviceFlag) { return false; }
 #define _AYMMAP_UNIMPL_ADVISE 1
+
+template <>
+bool MemMapTraits::populate(void * addr, size_type length, bool b_write) {
+    SYSTEM_INFO si;
+    ::GetSystemInfo(&si);
+    detail::_touchPages(addr, length, static_cast<size_type>(si.dwPageSize), b_write);
+    return true;
+}
+
+template <>
+bool MemMapTraits::pageFaults(std::uint64_t &, std::uint64_t &) { return false; }
+
+/**
+ * `WaitOnAddress` does not work across processes, waiters poll instead.
+ */
+template <>
+void MemMapTraits::waitAddress(std::uint32_t * addr, std::uint32_t expected) {
+    if (*reinterpret_cast<std::uint32_t volatile *>(addr) == expected) { ::Sleep(0); }
 }
 
+template <>
+void MemMapTraits::wakeAddress(std::uint32_t *, int) {}
+}
@@ -0,0 +1,191 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "aymmap/detail/interval.hpp"
+#include "aymmap/file/mmap.hpp"
+
+namespace aymmap {
+struct FlushPolicy {
+    // write-back period
+    std::chrono::milliseconds interval{1000};
+    // write-back early once this many bytes are marked dirty
+    std::size_t dirty_threshold = std::size_t(64) << 20;
+    // start write-back with `writeBack`, otherwise with an asynchronous `sync`
+    bool b_write_back = true;
+};
+
+/**
+ * Background flusher of a mapped file.
+ *
+ * Writers report what they touched with `markDirty`, the flusher thread
+ * starts write-back of those ranges periodically or once the dirty bytes
+ * reach the threshold. `syncPoint` waits for everything marked before it
+ * to be durable. If nothing is ever marked, sync points flush the whole file.
+ *
+ * The file must outlive the flusher and must not be remapped while running.
+ */
+template <typename FileT = MMapFile>
+class BasicMMapFlusher {
+public:
+    using file_type = FileT;
+    using size_type = typename file_type::size_type;
+
+    using callback_type = std::function<void(errno_t)>;
+
+    explicit BasicMMapFlusher(file_type & fi, FlushPolicy policy = FlushPolicy{}) noexcept
+        : m_file(fi), m_policy(policy) {}
+    ~BasicMMapFlusher() { stop(); }
+
+    file_type & file() noexcept { return m_file; }
+    FlushPolicy const & policy() const noexcept { return m_policy; }
+    bool isRunning() const noexcept { return m_thread.joinable(); }
+
+    errno_t start() {
+        if (isRunning()) [[unlikely]] { return kEnoOk; }
+        if (!m_file.isMapped()) [[unlikely]] { return kEnoUnmapped; }
+        if (m_file.isAnon()) [[unlikely]] { return kEnoMapIsAnon; }
+        {
+            std::lock_guard lk(m_mtx);
+            m_b_stop = false;
+        }
+        m_thread = std::thread(&BasicMMapFlusher::_run, this);
+        return kEnoOk;
+    }
+
+    // Pending sync points are completed before the thread exits.
+    void stop() {
+        if (!isRunning()) { return; }
+        {
+            std::lock_guard lk(m_mtx);
+            m_b_stop = true;
+        }
+        m_cv.notify_one();
+        m_thread.join();
+    }
+
+    void markDirty(size_type offset, size_type length) {
+        if (length == 0) [[unlikely]] { return; }
+        bool b_notify = false;
+        {
+            std::lock_guard lk(m_mtx);
+            m_dirty.add(offset, offset + length);
+            m_unsynced.add(offset, offset + length);
+            m_b_tracked = true;
+            b_notify = m_dirty.length() >= m_policy.dirty_threshold;
+        }
+        if (b_notify) { m_cv.notify_one(); }
+    }
+
+    std::future<errno_t> syncPoint() {
+        auto p_promise = std::make_shared<std::promise<errno_t>>();
+        auto fut = p_promise->get_future();
+        syncPoint([p_promise](errno_t en) { p_promise->set_value(en); });
+        return fut;
+    }
+
+    void syncPoint(callback_type cb) {
+        {
+            std::unique_lock lk(m_mtx);
+            if (!m_b_stop) [[likely]] {
+                m_requests.push_back(std::move(cb));
+                lk.unlock();
+                m_cv.notify_one();
+                return;
+            }
+        }
+        // not running or stopping, the thread may never serve the request
+        cb(m_file.flush());
+    }
+
+private:
+    using _range_set = detail::IntervalSet<size_type>;
+
+    void _run() {
+        std::unique_lock lk(m_mtx);
+        while (true) {
+            m_cv.wait_for(lk, m_policy.interval, [this] {
+                return m_b_stop || !m_requests.empty() ||
+                    m_dirty.length() >= m_policy.dirty_threshold;
+            });
+
+            auto const b_stop = m_b_stop;
+            auto requests = std::exchange(m_requests, {});
+            auto dirty = std::move(m_dirty);
+            _range_set unsynced;
+            bool b_whole = false;
+            if (!requests.empty()) {
+                unsynced = std::move(m_unsynced);
+                b_whole = !m_b_tracked;
+            }
+            lk.unlock();
+
+            if (!requests.empty()) {
+                errno_t en = kEnoOk;
+                if (b_whole) {
+                    en = m_file.flush();
+                } else {
+                    for (auto const & [beg, end] : unsynced) {
+                        if ((en = m_file.sync(beg, end - beg))) { break; }
+                    }
+                }
+                for (auto & cb : requests) { cb(en); }
+            } else {
+                for (auto const & [beg, end] : dirty) { _writeBack(beg, end - beg); }
+            }
+
+            lk.lock();
+            if (b_stop && m_requests.empty()) { break; }
+        }
+    }
+
+    void _writeBack(size_type offset, size_type length) {
+        if (m_policy.b_write_back && m_file.writeBack(offset, length) == kEnoOk) { return; }
+        if (auto en = m_file.sync(offset, length, true)) {
+            AYMMAP_DEBUG("Background write-back failed: ", en);
+        }
+    }
+
+    _AYMMAP_DISABLE_CLASS_COPY(BasicMMapFlusher)
+
+private:
+    file_type & m_file;
+    FlushPolicy m_policy;
+
+    std::thread m_thread;
+    std::mutex  m_mtx;
+    std::condition_variable m_cv;
+
+    std::vector<callback_type> m_requests;
+    _range_set m_dirty;
+    _range_set m_unsynced;
+    bool       m_b_tracked = false;
+    // set while no thread is serving requests
+    bool       m_b_stop = true;
+};
+using MMapFlusher = BasicMMapFlusher<MMapFile>;
+}
@@ -0,0 +1,279 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "aymmap/file/mmap.hpp"
+
+namespace aymmap {
+/**
+ * Pointer stored as the distance from itself to the pointee, so it stays
+ * valid wherever the mapping holding both of them is placed. Copies
+ * recompute the distance from their own address.
+ */
+template <typename T>
+class OffsetPtr {
+    template <typename> friend class OffsetPtr;
+
+public:
+    using element_type      = T;
+    using pointer           = T *;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_category = std::random_access_iterator_tag;
+
+    OffsetPtr() noexcept = default;
+    OffsetPtr(std::nullptr_t) noexcept {}
+    OffsetPtr(pointer p) noexcept { _set(p); }
+    OffsetPtr(OffsetPtr const & ot) noexcept { _set(ot.get()); }
+    template <typename U> requires std::is_convertible_v<U *, T *>
+    OffsetPtr(OffsetPtr<U> const & ot) noexcept { _set(ot.get()); }
+
+    OffsetPtr & operator=(OffsetPtr const & ot) noexcept {
+        _set(ot.get());
+        return *this;
+    }
+    OffsetPtr & operator=(pointer p) noexcept {
+        _set(p);
+        return *this;
+    }
+
+    pointer get() const noexcept {
+        if (m_offset == kNull) { return nullptr; }
+        return reinterpret_cast<pointer>(
+            const_cast<char *>(reinterpret_cast<char const *>(this)) + m_offset);
+    }
+
+    pointer operator->() const noexcept { return get(); }
+    template <typename U = T> requires (!std::is_void_v<U>)
+    U & operator*() const noexcept { return *get(); }
+    template <typename U = T> requires (!std::is_void_v<U>)
+    U & operator[](difference_type i) const noexcept { return get()[i]; }
+
+    explicit operator bool() const noexcept { return m_offset != kNull; }
+
+    OffsetPtr & operator+=(difference_type n) noexcept { m_offset += n * difference_type(sizeof(T)); return *this; }
+    OffsetPtr & operator-=(difference_type n) noexcept { m_offset -= n * difference_type(sizeof(T)); return *this; }
+    OffsetPtr & operator++() noexcept { return *this += 1; }
+    OffsetPtr & operator--() noexcept { return *this -= 1; }
+    friend OffsetPtr operator+(OffsetPtr p, difference_type n) noexcept { return p.get() + n; }
+    friend OffsetPtr operator-(OffsetPtr p, difference_type n) noexcept { return p.get() - n; }
+    friend difference_type operator-(OffsetPtr const & a, OffsetPtr const & b) noexcept {
+        return a.get() - b.get();
+    }
+
+    friend bool operator==(OffsetPtr const & a, OffsetPtr const & b) noexcept { return a.get() == b.get(); }
+    friend bool operator==(OffsetPtr const & a, std::nullptr_t) noexcept { return !a; }
+    friend auto operator<=>(OffsetPtr const & a, OffsetPtr const & b) noexcept {
+        return std::compare_three_way{}(a.get(), b.get());
+    }
+
+private:
+    // an object never points to its own second byte
+    static constexpr difference_type kNull = 1;
+
+    void _set(pointer p) noexcept {
+        m_offset = p ? reinterpret_cast<char const *>(p) - reinterpret_cast<char const *>(this) : kNull;
+    }
+
+    difference_type m_offset = kNull;
+};
+
+/**
+ * Heap inside a mapped file. Everything it manages, the free lists and a
+ * root object included, is addressed by offset, so structures linked with
+ * `OffsetPtr` are usable as soon as the file is mapped again.
+ *
+ * Blocks are rounded to a power of two and recycled per size class. The
+ * file grows geometrically; give `open` a reservation to keep the base
+ * address, and therefore raw pointers, stable across growth. Calls are
+ * not synchronized.
+ */
+template <typename FileT = MMapFile>
+class BasicMMapHeap {
+public:
+    using file_type = FileT;
+    using path_cref = typename file_type::path_cref;
+    using size_type = typename file_type::size_type;
+
+    static constexpr std::uint64_t kMagic   = 0x5041'4548'5041'4d59ull; // "YMAPHEAP"
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr size_type kAlign = 16;
+
+private:
+    static constexpr size_type kMinShift   = 4;
+    static constexpr size_type kClassCount = 48;
+
+    struct _Header {
+        std::uint64_t magic;
+        std::uint32_t version;
+        std::uint32_t header_size;
+        std::uint64_t top;
+        std::uint64_t root;
+        std::uint64_t free_heads[kClassCount];
+    };
+
+    struct alignas(kAlign) _Block {
+        std::uint64_t cls;
+        std::uint64_t next;
+    };
+
+    static constexpr size_type kDataBeg = (sizeof(_Header) + kAlign - 1) & ~(kAlign - 1);
+
+public:
+    BasicMMapHeap() = default;
+    ~BasicMMapHeap() = default;
+    BasicMMapHeap(BasicMMapHeap &&) = default;
+    BasicMMapHeap & operator=(BasicMMapHeap &&) = default;
+
+    /**
+     * Open or create the heap in file `ph`. A non-zero `reserved` keeps the
+     * base address fixed while the heap grows up to that size.
+     */
+    errno_t open(path_cref ph, size_type initial_size = size_type(1) << 20, size_type reserved = 0) {
+        m_file.unmap();
+        if (reserved) {
+            if (auto en = m_file.reserve(reserved)) { return en; }
+        }
+        if (auto en = m_file.map(ph, AccessFlag::kDefault)) {
+            if (en != kEnoInviArgs) { return en; }
+            // new or empty file
+            if (reserved) { m_file.reserve(reserved); }
+            en = m_file.map(ph, AccessFlag::kDefault, std::max(initial_size, kDataBeg));
+            if (en) { return en; }
+        }
+        if (m_file.size() < kDataBeg) [[unlikely]] {
+            if (auto en = m_file.resize(std::max(initial_size, kDataBeg))) { return en; }
+        }
+
+        auto & header = _header();
+        if (header.magic == 0) {
+            header = _Header{};
+            header.version     = kVersion;
+            header.header_size = sizeof(_Header);
+            header.top         = kDataBeg;
+            header.magic       = kMagic;
+        } else if (header.magic != kMagic || header.version != kVersion ||
+                   header.header_size != sizeof(_Header) || header.top > m_file.size()) [[unlikely]] {
+            m_file.unmap();
+            return kEnoInviArgs;
+        }
+        return kEnoOk;
+    }
+
+    errno_t close() { return m_file.unmap(); }
+    errno_t flush(bool b_async = false) { return m_file.flush(b_async); }
+
+    bool isOpen() const noexcept { return m_file.isMapped(); }
+    file_type const & file() const noexcept { return m_file; }
+    // Bytes handed out or on free lists.
+    size_type used() const noexcept { return isOpen() ? _header().top - kDataBeg : 0; }
+
+    /**
+     * `nullptr` when the file cannot grow. Raw pointers into the heap are
+     * invalidated by growth unless the heap was opened with a reservation.
+     */
+    void * allocate(size_type bytes) noexcept {
+        if (!isOpen()) [[unlikely]] { return nullptr; }
+        auto const cls = _classOf(bytes);
+        if (cls >= kClassCount) [[unlikely]] { return nullptr; }
+
+        auto & head = _header().free_heads[cls];
+        if (head) {
+            auto * p_block = _at<_Block>(head);
+            head = p_block->next;
+            return p_block + 1;
+        }
+
+        auto const length = sizeof(_Block) + (size_type(1) << (cls + kMinShift));
+        auto const offset = _header().top;
+        if (offset + length > m_file.size()) {
+            auto const new_size = std::max(offset + length, m_file.size() * 2);
+            if (auto en = m_file.resize(new_size)) {
+                AYMMAP_DEBUG("Failed to grow the heap: ", en);
+                return nullptr;
+            }
+        }
+        _header().top = offset + length;
+        auto * p_block = _at<_Block>(offset);
+        p_block->cls  = cls;
+        p_block->next = 0;
+        return p_block + 1;
+    }
+
+    void deallocate(void * p) noexcept {
+        if (!p) [[unlikely]] { return; }
+        auto * p_block = static_cast<_Block *>(p) - 1;
+        auto & head = _header().free_heads[p_block->cls];
+        p_block->next = head;
+        head = toOffset(p_block);
+    }
+
+    template <typename T, typename... Args>
+    T * construct(Args &&... args) {
+        static_assert(alignof(T) <= kAlign);
+        auto * p = allocate(sizeof(T));
+        if (!p) [[unlikely]] { return nullptr; }
+        return ::new (p) T(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    void destroy(T * p) noexcept {
+        if (!p) [[unlikely]] { return; }
+        p->~T();
+        deallocate(p);
+    }
+
+    // Object every other one is reached from, `nullptr` in a new heap.
+    template <typename T>
+    T * root() noexcept {
+        if (!isOpen() || !_header().root) { return nullptr; }
+        return _at<T>(_header().root);
+    }
+
+    void setRoot(void const * p) noexcept { _header().root = p ? toOffset(p) : 0; }
+
+    std::uint64_t toOffset(void const * p) const noexcept {
+        return std::uint64_t(static_cast<char const *>(p) - m_file.data());
+    }
+
+    template <typename T>
+    T * fromOffset(std::uint64_t offset) noexcept { return _at<T>(offset); }
+
+private:
+    static size_type _classOf(size_type bytes) noexcept {
+        bytes = std::max(bytes, size_type(1) << kMinShift);
+        return size_type(std::bit_width(bytes - 1)) - kMinShift;
+    }
+
+    _Header & _header() noexcept { return *reinterpret_cast<_Header *>(m_file.data()); }
+    _Header const & _header() const noexcept { return *reinterpret_cast<_Header const *>(m_file.data()); }
+
+    template <typename T>
+    T * _at(std::uint64_t offset) noexcept { return reinterpret_cast<T *>(m_file.data() + offset); }
+
+private:
+    file_type m_file;
+};
+using MMapHeap = BasicMMapHeap<MMapFile>;
+}
@@ -0,0 +1,353 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "aymmap/detail/scan.hpp"
+#include "aymmap/file/mmap.hpp"
+
+namespace aymmap {
+/**
+ * Index of line start offsets of a mapped file.
+ *
+ * `build` scans chunks of the file in parallel. The index is delta-encoded
+ * as LEB128 varints with an absolute anchor every 64 lines, so `offset(n)`
+ * decodes at most 63 varints. `build` given the path of the indexed file
+ * stamps the index with its size and modification time, `save` writes
+ * index and stamp to a sidecar file with a checksum, and `load` maps the
+ * sidecar and refuses it with `kEnoStale` when the file has changed since
+ * it was indexed.
+ */
+template <typename FileT = MMapFile>
+class BasicMMapLineIndex {
+public:
+    using file_type = FileT;
+    using path_cref = typename file_type::path_cref;
+    using size_type = typename file_type::size_type;
+    using byte_type = typename file_type::byte_type;
+    using view_type = std::basic_string_view<byte_type>;
+
+    static constexpr std::uint64_t kMagic   = 0x5844'4e49'5041'4d59ull; // "YMAPINDX"
+    static constexpr std::uint32_t kVersion = 1;
+    static constexpr size_type kBlockShift = 6;
+    static constexpr size_type kBlockSize  = size_type(1) << kBlockShift;
+
+private:
+    struct _Header {
+        std::uint64_t magic;
+        std::uint32_t version;
+        std::uint32_t sep;
+        std::uint64_t source_size;
+        std::int64_t  source_mtime;
+        std::uint64_t line_count;
+        std::uint64_t delta_bytes;
+        std::uint64_t checksum;
+    };
+
+    struct _Anchor {
+        std::uint64_t offset;
+        std::uint64_t pos;
+    };
+
+public:
+    BasicMMapLineIndex() = default;
+    ~BasicMMapLineIndex() = default;
+    BasicMMapLineIndex(BasicMMapLineIndex &&) = default;
+    BasicMMapLineIndex & operator=(BasicMMapLineIndex &&) = default;
+
+    /**
+     * Index the lines of `fi` with `n_threads` workers, all hardware
+     * threads if zero.
+     */
+    errno_t build(file_type const & fi, unsigned n_threads = 0, byte_type sep = byte_type('\n')) {
+        if (!fi.isMapped()) [[unlikely]] { return kEnoUnmapped; }
+        clear();
+        auto const * p_data = reinterpret_cast<char const *>(fi.data());
+        auto const length = fi.size();
+
+        if (n_threads == 0) { n_threads = std::max(1u, std::thread::hardware_concurrency()); }
+        auto const chunk = std::max<size_type>((length + n_threads - 1) / n_threads, size_type(1) << 16);
+        auto const chunk_count = std::max<size_type>(1, (length + chunk - 1) / chunk);
+
+        // line starts of each chunk, the first line of the file is implied
+        std::vector<std::vector<std::uint64_t>> starts(chunk_count);
+        _parallel(chunk_count, [&](size_type i) {
+            auto const beg = i * chunk;
+            auto const end = std::min(length, beg + chunk);
+            constexpr size_type kBatch = 1024;
+            size_type offsets[kBatch];
+            auto & out = starts[i];
+            for (auto pos = beg; pos < end;) {
+                auto const n = detail::findEach(p_data + pos, end - pos, char(sep), offsets, kBatch);
+                for (size_type k = 0; k < n; ++k) {
+                    auto const next = pos + offsets[k] + 1;
+                    if (next < length) { out.push_back(next); }
+                }
+                if (n < kBatch) { break; }
+                pos += offsets[n - 1] + 1;
+            }
+        });
+
+        // number the lines, then encode every chunk on its own
+        std::vector<size_type> first_line(chunk_count + 1);
+        first_line[0] = 1;
+        for (size_type i = 0; i < chunk_count; ++i) { first_line[i + 1] = first_line[i] + starts[i].size(); }
+        auto const line_count = length ? first_line[chunk_count] : 0;
+        auto const anchor_count = (line_count + kBlockSize - 1) >> kBlockShift;
+
+        std::vector<_Anchor> anchors(anchor_count);
+        std::vector<std::vector<std::uint8_t>> deltas(chunk_count);
+        if (anchor_count) { anchors[0] = _Anchor{0, 0}; }
+        std::vector<std::uint64_t> prev_start(chunk_count, 0);
+        for (size_type i = 1; i < chunk_count; ++i) {
+            prev_start[i] = starts[i - 1].empty() ? prev_start[i - 1] : starts[i - 1].back();
+        }
+        _parallel(chunk_count, [&](size_type i) {
+            auto prev = prev_start[i];
+            auto line = first_line[i];
+            auto & out = deltas[i];
+            out.reserve(starts[i].size() * 2);
+            for (auto start : starts[i]) {
+                if ((line & (kBlockSize - 1)) == 0) {
+                    anchors[line >> kBlockShift] = _Anchor{start, out.size()};
+                } else {
+                    _putVarint(out, start - prev);
+                }
+                prev = start;
+                ++line;
+            }
+            std::vector<std::uint64_t>{}.swap(starts[i]);
+        });
+
+        // anchor positions are relative to their chunk until concatenated
+        std::vector<size_type> delta_beg(chunk_count + 1, 0);
+        for (size_type i = 0; i < chunk_count; ++i) { delta_beg[i + 1] = delta_beg[i] + deltas[i].size(); }
+        for (size_type i = 0; i < chunk_count; ++i) {
+            auto const a_beg = (first_line[i] + kBlockSize - 1) >> kBlockShift;
+            auto const a_end = (first_line[i + 1] + kBlockSize - 1) >> kBlockShift;
+            for (auto a = std::max<size_type>(a_beg, 1); a < a_end; ++a) { anchors[a].pos += delta_beg[i]; }
+        }
+
+        auto const anchor_bytes = anchor_count * sizeof(_Anchor);
+        m_image.resize(sizeof(_Header) + anchor_bytes + delta_beg[chunk_count]);
+        auto * p_image = m_image.data();
+        if (anchor_bytes) { std::memcpy(p_image + sizeof(_Header), anchors.data(), anchor_bytes); }
+        for (size_type i = 0; i < chunk_count; ++i) {
+            if (deltas[i].empty()) { continue; }
+            std::memcpy(p_image + sizeof(_Header) + anchor_bytes + delta_beg[i], deltas[i].data(), deltas[i].size());
+        }
+
+        _Header header{};
+        header.magic       = kMagic;
+        header.version     = kVersion;
+        header.sep         = static_cast<std::uint8_t>(sep);
+        header.source_size = length;
+        header.line_count  = line_count;
+        header.delta_bytes = delta_beg[chunk_count];
+        header.checksum    = _checksum(p_image + sizeof(_Header), m_image.size() - sizeof(_Header));
+        std::memcpy(p_image, &header, sizeof(header));
+        _attach(p_image, m_image.size());
+        return kEnoOk;
+    }
+
+    /**
+     * Index `fi`, the mapping of `source`, stamped with the size and
+     * modification time `source` has before the scan, so any later edit
+     * makes a saved sidecar stale.
+     */
+    errno_t build(file_type const & fi, path_cref source,
+        unsigned n_threads = 0, byte_type sep = byte_type('\n')) {
+        std::error_code ec;
+        auto const mtime = fs::last_write_time(source, ec);
+        if (ec) { return ec.value(); }
+        auto const source_size = fs::file_size(source, ec);
+        if (ec) { return ec.value(); }
+        if (source_size != fi.size()) [[unlikely]] { return kEnoStale; }
+        if (auto en = build(fi, n_threads, sep)) { return en; }
+        auto const stamp = std::int64_t(mtime.time_since_epoch().count());
+        std::memcpy(m_image.data() + offsetof(_Header, source_mtime), &stamp, sizeof(stamp));
+        return kEnoOk;
+    }
+
+    /**
+     * Write the index and its stamp to `sidecar`. An index built without
+     * the path of its file carries no stamp and never loads as fresh.
+     */
+    errno_t save(path_cref sidecar) {
+        if (!m_p_header) [[unlikely]] { return kEnoInviArgs; }
+        auto const length = sizeof(_Header) + _payloadSize();
+        file_type fi;
+        if (auto en = fi.map(sidecar, AccessFlag::kDefault | AccessFlag::kResize, length)) { return en; }
+        std::memcpy(fi.data(), m_p_header, length);
+        if (auto en = fi.flush()) { return en; }
+
+        m_p_header = nullptr;
+        m_image.clear();
+        m_file = std::move(fi);
+        _attach(reinterpret_cast<std::uint8_t const *>(m_file.data()), m_file.size());
+        return kEnoOk;
+    }
+
+    /**
+     * Map the index in `sidecar`, `kEnoStale` if `source` changed since it
+     * was saved or the content does not match its checksum.
+     */
+    errno_t load(path_cref sidecar, path_cref source) {
+        clear();
+        file_type fi;
+        if (auto en = fi.map(sidecar, AccessFlag::kReadOnly)) { return en; }
+        if (fi.size() < sizeof(_Header)) [[unlikely]] { return kEnoStale; }
+
+        _Header header;
+        std::memcpy(&header, fi.data(), sizeof(header));
+        if (header.magic != kMagic || header.version != kVersion) [[unlikely]] { return kEnoStale; }
+        auto const anchor_count = (header.line_count + kBlockSize - 1) >> kBlockShift;
+        if (fi.size() != sizeof(_Header) + anchor_count * sizeof(_Anchor) + header.delta_bytes) [[unlikely]] {
+            return kEnoStale;
+        }
+
+        std::error_code ec;
+        auto const source_size = fs::file_size(source, ec);
+        if (ec) { return ec.value(); }
+        auto const mtime = fs::last_write_time(source, ec);
+        if (ec) { return ec.value(); }
+        if (header.source_size != source_size ||
+            header.source_mtime != std::int64_t(mtime.time_since_epoch().count())) {
+            return kEnoStale;
+        }
+
+        auto const * p_image = reinterpret_cast<std::uint8_t const *>(fi.data());
+        if (header.checksum != _checksum(p_image + sizeof(_Header), fi.size() - sizeof(_Header))) {
+            return kEnoStale;
+        }
+        m_file = std::move(fi);
+        _attach(p_image, m_file.size());
+        return kEnoOk;
+    }
+
+    /**
+     * `load` the sidecar of `source`, or `build` from `fi` and `save` it
+     * when it is missing or stale.
+     */
+    errno_t loadOrBuild(file_type const & fi, path_cref source, path_cref sidecar,
+        unsigned n_threads = 0, byte_type sep = byte_type('\n')) {
+        auto en = load(sidecar, source);
+        if (!en && m_p_header->sep == std::uint8_t(sep)) { return kEnoOk; }
+        if ((en = build(fi, source, n_threads, sep))) { return en; }
+        return save(sidecar);
+    }
+
+    void clear() noexcept {
+        m_file.unmap();
+        m_image.clear();
+        m_p_header  = nullptr;
+        m_p_anchors = nullptr;
+        m_p_deltas  = nullptr;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+    // Number of lines, a trailing separator does not start a line.
+    size_type size() const noexcept { return m_p_header ? size_type(m_p_header->line_count) : 0; }
+
+    // Offset of the first byte of line `n`, the indexed length past the last line.
+    size_type offset(size_type n) const noexcept {
+        if (n >= size()) [[unlikely]] { return m_p_header ? size_type(m_p_header->source_size) : 0; }
+        auto const & anchor = m_p_anchors[n >> kBlockShift];
+        auto offset = anchor.offset;
+        auto const * p = m_p_deltas + anchor.pos;
+        for (auto i = n & (kBlockSize - 1); i; --i) { offset += _getVarint(p); }
+        return size_type(offset);
+    }
+
+    // Line `n` of `fi`, separator included, empty past the last line.
+    view_type line(file_type const & fi, size_type n) const noexcept {
+        if (n >= size()) [[unlikely]] { return {}; }
+        auto const beg = offset(n);
+        auto const end = n + 1 < size() ? offset(n + 1) : fi.size();
+        return view_type(fi.data() + beg, end - beg);
+    }
+
+private:
+    template <typename FnT>
+    static void _parallel(size_type count, FnT && fn) {
+        std::vector<std::jthread> workers;
+        workers.reserve(count - 1);
+        for (size_type i = 1; i < count; ++i) { workers.emplace_back(fn, i); }
+        fn(size_type(0));
+    }
+
+    static void _putVarint(std::vector<std::uint8_t> & out, std::uint64_t val) {
+        while (val >= 0x80) {
+            out.push_back(std::uint8_t(val) | 0x80);
+            val >>= 7;
+        }
+        out.push_back(std::uint8_t(val));
+    }
+
+    static std::uint64_t _getVarint(std::uint8_t const *& p) noexcept {
+        std::uint64_t val = 0;
+        for (unsigned shift = 0;; shift += 7) {
+            auto const b = *p++;
+            val |= std::uint64_t(b & 0x7f) << shift;
+            if (!(b & 0x80)) { return val; }
+        }
+    }
+
+    // FNV-1a over 8-byte words, the tail byte-wise.
+    static std::uint64_t _checksum(std::uint8_t const * p, size_type length) noexcept {
+        constexpr std::uint64_t kPrime = 0x100000001b3ull;
+        std::uint64_t hash = 0xcbf29ce484222325ull;
+        size_type i = 0;
+        for (; i + 8 <= length; i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, p + i, 8);
+            hash = (hash ^ word) * kPrime;
+        }
+        for (; i < length; ++i) { hash = (hash ^ p[i]) * kPrime; }
+        return hash;
+    }
+
+    size_type _payloadSize() const noexcept {
+        auto const anchor_count = (m_p_header->line_count + kBlockSize - 1) >> kBlockShift;
+        return size_type(anchor_count * sizeof(_Anchor) + m_p_header->delta_bytes);
+    }
+
+    void _attach(std::uint8_t const * p_image, size_type) noexcept {
+        m_p_header  = reinterpret_cast<_Header const *>(p_image);
+        m_p_anchors = reinterpret_cast<_Anchor const *>(p_image + sizeof(_Header));
+        auto const anchor_count = (m_p_header->line_count + kBlockSize - 1) >> kBlockShift;
+        m_p_deltas  = p_image + sizeof(_Header) + anchor_count * sizeof(_Anchor);
+    }
+
+    _AYMMAP_DISABLE_CLASS_COPY(BasicMMapLineIndex)
+
+private:
+    file_type m_file;
+    std::vector<std::uint8_t> m_image;
+    _Header const * m_p_header  = nullptr;
+    _Anchor const * m_p_anchors = nullptr;
+    std::uint8_t const * m_p_deltas = nullptr;
+};
+using MMapLineIndex = BasicMMapLineIndex<MMapFile>;
+}
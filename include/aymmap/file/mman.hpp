@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <filesystem>
 
 #include "aymmap/global.hpp"
@@ -22,6 +23,26 @@
 namespace aymmap {
 template <typename> class FileHandleConverter;
 
+namespace detail {
+/**
+ * Fault in every page of the range by touching one byte per page.
+ * The write touch is an atomic `or 0`, so concurrent writers are not lost.
+ */
+inline void _touchPages(void * addr, std::size_t length, std::size_t stride, bool b_write) {
+    auto * p_beg = static_cast<char *>(addr);
+    auto * p_end = p_beg + length;
+    if (b_write) {
+        for (auto * p = p_beg; p < p_end; p += stride) {
+            std::atomic_ref<char>(*p).fetch_or(0, std::memory_order_relaxed);
+        }
+    } else {
+        for (auto * p = p_beg; p < p_end; p += stride) {
+            static_cast<void>(*static_cast<char volatile *>(p));
+        }
+    }
+}
+}
+
 template <typename T>
 struct BasicMemMapTraits {
     using data_type   = T;
@@ -34,24 +55,44 @@ struct BasicMemMapTraits {
 
     static errno_t lastErrno();
     static off_type pageSize();
+    static size_type hugePageSize(AccessFlag);
 
     static bool checkHandle(handle_type);
     static handle_type dupHandle(handle_type);
 
     static size_type fileSize(handle_type);
     static handle_type fileOpen(path_cref, AccessFlag);
+    static handle_type memFileCreate(char const * name, AccessFlag = AccessFlag::kDefault);
+    static handle_type shmOpen(char const * name, AccessFlag);
+    static bool shmUnlink(char const * name);
+    static bool fileSeal(handle_type, SealFlag);
+    static bool fileSeals(handle_type, SealFlag &);
     static bool fileClose(handle_type);
     static bool fileResize(handle_type, size_type new_size);
+    static bool fileAllocate(handle_type, off_type offset, size_type length);
+    static bool fileSync(handle_type);
+    static bool fileAdvise(handle_type, off_type offset, size_type length, AdviceFlag);
 
     static bool map(data_type &, AccessFlag, size_type length, off_type offset);
+    static bool mapFixed(data_type &, void * addr, AccessFlag, size_type length, off_type offset);
     static bool unmap(data_type &);
     static bool remap(data_type &, size_type new_length);
 
     static bool sync(void *, size_type length);
+    static bool syncAsync(void *, size_type length);
+    static bool writeBack(handle_type, off_type offset, size_type length);
     static bool lock(void *, size_type length);
+    static bool lockOnFault(void *, size_type length);
     static bool unlock(void *, size_type length);
     static bool protect(void *, size_type length, AccessFlag);
     static bool advise(void *, size_type length, AdviceFlag);
+    static bool isAdviceSupported(AdviceFlag);
+    static bool populate(void *, size_type length, bool b_write);
+
+    static bool pageFaults(std::uint64_t & minor, std::uint64_t & major);
+
+    static void waitAddress(std::uint32_t * addr, std::uint32_t expected);
+    static void wakeAddress(std::uint32_t * addr, int count);
 };
 }
 
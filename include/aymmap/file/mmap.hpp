@@ -15,7 +15,15 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concepts>
 #include <iterator>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "aymmap/global.hpp"
 #include "aymmap/file/mman.hpp"
@@ -26,6 +34,24 @@ namespace aymmap {
 template <typename...> class MMapFileFriend;
 #endif
 
+/**
+ * Element types that may be viewed in place inside a mapping. Endian-tagged
+ * scalars such as `be_u32` qualify and have no alignment requirement.
+ */
+template <typename T>
+concept MMapViewable = std::is_trivially_copyable_v<T> && !std::is_const_v<T>;
+
+template <typename T>
+using MMapSpan = std::span<T>;
+
+struct PrefaultStats {
+    std::size_t   length  = 0;
+    unsigned      threads = 0;
+    std::uint64_t minor_faults = 0;
+    std::uint64_t major_faults = 0;
+    std::chrono::nanoseconds elapsed{};
+};
+
 template <typename ByteT,
     typename _TraitsT = MemMapTraits,
     typename _UtilsT  = FileUtils<_TraitsT>
@@ -70,7 +96,9 @@ public:
     }
 
     errno_t map(path_cref, AccessFlag, size_type length = kInvalidSize, size_type offset = 0);
-    errno_t anonMap(size_type length);
+    errno_t anonMap(size_type length, AccessFlag = AccessFlag::kDefault);
+    errno_t memMap(size_type length, AccessFlag = AccessFlag::kDefault, char const * name = "aymmap");
+    errno_t shmMap(char const * name, AccessFlag, size_type length = kInvalidSize);
 
     template <typename FileT>
     errno_t fileMap(FileT file, AccessFlag flag, bool b_dup = true,
@@ -79,26 +107,50 @@ public:
         return _fileMap(utils_type::toFileHandle(file), flag, b_dup, length, offset);
     }
 
+    errno_t reserve(size_type length);
     errno_t unmap();
-    errno_t flush();
-    errno_t sync(size_type offset, size_type length);
+    errno_t flush(bool b_async = false);
+    errno_t sync(size_type offset, size_type length, bool b_async = false);
+    errno_t writeBack(size_type offset = 0, size_type length = kInvalidSize);
+    errno_t fileAdvise(AdviceFlag, size_type offset, size_type length);
     errno_t remap(AccessFlag, size_type length, size_type offset);
     errno_t resize(size_type new_length);
-    errno_t lock();
+    errno_t lock(bool b_on_fault = false);
+    errno_t lock(size_type offset, size_type length, bool b_on_fault = false);
+    // `lock(n)` would convert `n` to `b_on_fault`, a range needs both bounds.
+    template <std::integral I> requires (!std::same_as<I, bool>)
+    errno_t lock(I) = delete;
     errno_t unlock();
+    errno_t unlock(size_type offset, size_type length);
     errno_t protect(AccessFlag);
+    errno_t protect(AccessFlag, size_type offset, size_type length);
     errno_t advise(AdviceFlag);
+    errno_t advise(AdviceFlag, size_type offset, size_type length);
+    errno_t prefault(bool b_write = false, unsigned n_threads = 1, PrefaultStats * = nullptr);
+    errno_t seal(SealFlag);
+    errno_t seals(SealFlag &) const;
+
+    static errno_t shmUnlink(char const * name) {
+        return _throwErrno(traits_type::shmUnlink(name));
+    }
 
     bool isMapped() const noexcept { return bool(m_p_byte); }
     bool isAnon() const noexcept { return isMapped() && _isAnon(); }
     bool empty() const noexcept { return size() == 0; }
 
     size_type     size() const noexcept { return m_length; }
+    size_type     mappedPageSize() const noexcept { return m_data.page_size_; }
+    AccessFlag    accessFlag() const noexcept { return m_data.access_; }
+    size_type     reserved() const noexcept { return m_data.reserved_; }
     pointer       data() noexcept { return m_p_byte; }
     const_pointer data() const noexcept { return m_p_byte; }
     const_pointer c_str() const noexcept { return m_p_byte; }
 
     handle_type fileHandle() const noexcept { return m_data.file_handle_; }
+    // File offset of the first byte of the view.
+    off_type fileOffset() const noexcept {
+        return m_p_byte ? m_data.offset_ + off_type(m_p_byte - static_cast<const_pointer>(m_data.p_data_)) : 0;
+    }
 
     iterator       begin() noexcept { return data(); }
     const_iterator begin() const noexcept { return data(); }
@@ -117,7 +169,39 @@ public:
     byte_type &       operator[](size_type i) noexcept { return m_p_byte[i]; }
     byte_type const & operator[](size_type i) const noexcept { return m_p_byte[i]; }
 
+    /**
+     * Typed view of `count` elements at byte `offset`, `kInvalidSize` takes
+     * as many as fit. Returns an empty span if the range is out of bounds or
+     * the address is not aligned for `T`.
+     */
+    template <MMapViewable T>
+    MMapSpan<T> view(size_type offset, size_type count = kInvalidSize) noexcept {
+        return _view<T>(m_p_byte, offset, count);
+    }
+    template <MMapViewable T>
+    MMapSpan<T const> view(size_type offset, size_type count = kInvalidSize) const noexcept {
+        return _view<T const>(m_p_byte, offset, count);
+    }
+
 private:
+    template <typename T, typename P>
+    MMapSpan<T> _view(P p_byte, size_type offset, size_type count) const noexcept {
+        if (!p_byte || offset > m_length) [[unlikely]] { return {}; }
+        auto const avail = (m_length - offset) / sizeof(T);
+        if (count == kInvalidSize) {
+            count = avail;
+        } else if (count > avail) [[unlikely]] {
+            AYMMAP_DEBUG("View out of bounds: ", offset, " + ", count, " x ", sizeof(T));
+            return {};
+        }
+        auto p = p_byte + offset;
+        if (reinterpret_cast<std::uintptr_t>(p) % alignof(T)) [[unlikely]] {
+            AYMMAP_DEBUG("Misaligned view at offset ", offset);
+            return {};
+        }
+        return {reinterpret_cast<T *>(p), count};
+    }
+
     void _reset();
     void _move(BasicMMapFile && ot) noexcept {
         m_p_byte = std::exchange(ot.m_p_byte, nullptr);
@@ -128,9 +212,11 @@ private:
 
     bool _isAnon() const noexcept { return fileHandle() == kInvalidHandle; }
 
+    errno_t _pageRange(size_type, size_type, void *&, size_type &) const noexcept;
     errno_t _mapImpl(AccessFlag, size_type, off_type);
     errno_t _mapFileImpl(AccessFlag, size_type, size_type);
     errno_t _fileMap(handle_type, AccessFlag, bool, size_type, size_type);
+    errno_t _memMapImpl(size_type, AccessFlag, char const *);
 
     _AYMMAP_DISABLE_CLASS_COPY(BasicMMapFile)
 
@@ -159,11 +245,64 @@ errno_t BasicMMapFile<T, T2, T3>::map(path_cref ph,
 }
 
 template <typename T, typename T2, typename T3>
-errno_t BasicMMapFile<T, T2, T3>::anonMap(size_type length) {
+errno_t BasicMMapFile<T, T2, T3>::anonMap(size_type length, AccessFlag flag) {
     if (isMapped()) [[unlikely]] { if (auto en = unmap()) { return en; } }
     if (length == 0 || length == kInvalidSize) { return kEnoInviArgs; }
     m_data.file_handle_ = kInvalidHandle;
-    auto en = _mapImpl(AccessFlag::kDefault, length, 0);
+    auto en = _mapImpl(flag, length, 0);
+    if (en) { _reset(); }
+    return en;
+}
+
+/**
+ * Map a new anonymous memory file of `length` bytes. Unlike `anonMap` the
+ * mapping has a file handle, which can be passed to other processes and
+ * sealed. Huge page options fall back to normal pages when unavailable.
+ */
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFile<T, T2, T3>::memMap(size_type length, AccessFlag flag, char const * name) {
+    if (isMapped()) [[unlikely]] { if (auto en = unmap()) { return en; } }
+    if (length == 0 || length == kInvalidSize) { return kEnoInviArgs; }
+    if (bool(flag & AccessFlag::_kHugeTLB)) {
+        if (!_memMapImpl(length, flag, name)) { return kEnoOk; }
+        AYMMAP_DEBUG("Huge page memory file failed, fall back to normal pages.");
+        flag = flag & ~AccessFlag::kHugeTLB1GB & ~AccessFlag::kHugeTLB2MB;
+    }
+    return _memMapImpl(length, flag, name);
+}
+
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFile<T, T2, T3>::_memMapImpl(size_type length, AccessFlag flag, char const * name) {
+    auto file_handle = traits_type::memFileCreate(name, flag);
+    if (!traits_type::checkHandle(file_handle)) [[unlikely]] { return _throwErrno(false); }
+    m_data.file_handle_ = file_handle;
+    m_b_internal_file   = true;
+
+    auto file_sz = length;
+    if (bool(flag & AccessFlag::_kHugeTLB)) {
+        auto const huge_size = traits_type::hugePageSize(flag);
+        file_sz = (length + huge_size - 1) & ~(huge_size - 1);
+    }
+    auto en = _throwErrno(traits_type::fileResize(file_handle, file_sz));
+    if (!en) { en = _mapFileImpl(flag, length, 0); }
+    if (en) { _reset(); }
+    return en;
+}
+
+/**
+ * Create or attach the named shared memory segment `name`. A new segment
+ * is sized to `length` when `flag` allows creating it.
+ */
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFile<T, T2, T3>::shmMap(char const * name, AccessFlag flag, size_type length) {
+    if (isMapped()) [[unlikely]] { if (auto en = unmap()) { return en; } }
+
+    auto file_handle = traits_type::shmOpen(name, flag);
+    if (!traits_type::checkHandle(file_handle)) [[unlikely]] { return _throwErrno(false); }
+    m_data.file_handle_ = file_handle;
+    m_b_internal_file   = true;
+
+    auto en = _mapFileImpl(flag, length, 0);
     if (en) { _reset(); }
     return en;
 }
@@ -229,6 +368,20 @@ errno_t BasicMMapFile<T, T2, T3>::_mapImpl(
     return en;
 }
  
+/**
+ * Reserve `length` bytes of address space for the next map. The view is
+ * placed at the start of the reservation and `resize` then grows or shrinks
+ * it in place, so `data()` and views into the mapping stay valid.
+ * Growing beyond the reservation fails.
+ */
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFile<T, T2, T3>::reserve(size_type length) {
+    if (isMapped()) [[unlikely]] { return kEnoInviArgs; }
+    auto const page_size = static_cast<size_type>(utils_type::pageSize());
+    m_data.reserved_ = (length + page_size - 1) & ~(page_size - 1);
+    return kEnoOk;
+}
+
 template <typename T, typename T2, typename T3>
 errno_t BasicMMapFile<T, T2, T3>::unmap() {
     if (!isMapped()) { return _throwErrno(true); }
@@ -239,20 +392,71 @@ errno_t BasicMMapFile<T, T2, T3>::unmap() {
 }
 
 template <typename T, typename T2, typename T3>
-errno_t BasicMMapFile<T, T2, T3>::flush() {
+errno_t BasicMMapFile<T, T2, T3>::flush(bool b_async) {
     if (!isMapped()) [[unlikely]] { return kEnoUnmapped; }
     if (isAnon()) [[unlikely]] { return kEnoMapIsAnon; }
+    if (b_async) { return _throwErrno(traits_type::syncAsync(m_data.p_data_, m_data.length_)); }
     return _throwErrno(traits_type::sync(m_data.p_data_, m_data.length_));
 }
 
 template <typename T, typename T2, typename T3>
 errno_t BasicMMapFile<T, T2, T3>::sync(
-    size_type offset, size_type length) {
+    size_type offset, size_type length, bool b_async) {
+    if (!isMapped()) [[unlikely]] { return kEnoUnmapped; }
+    if (isAnon()) [[unlikely]] { return kEnoMapIsAnon; }
+    void * addr = nullptr;
+    if (auto en = _pageRange(offset, length, addr, length)) { return en; }
+    if (b_async) { return _throwErrno(traits_type::syncAsync(addr, length)); }
+    return _throwErrno(traits_type::sync(addr, length));
+}
+
+/**
+ * Start write-back of `[offset, offset + length)` and return immediately.
+ * Unlike `sync`, this gives no durability guarantee.
+ */
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFile<T, T2, T3>::writeBack(size_type offset, size_type length) {
+    if (!isMapped()) [[unlikely]] { return kEnoUnmapped; }
+    if (isAnon()) [[unlikely]] { return kEnoMapIsAnon; }
+    if (m_length <= offset) [[unlikely]] { return kEnoInviArgs; }
+    if (m_length - offset < length) { length = m_length - offset; }
+    auto const head = off_type(m_p_byte - reinterpret_cast<pointer>(m_data.p_data_));
+    return _throwErrno(traits_type::writeBack(m_data.file_handle_,
+        m_data.offset_ + head + off_type(offset), length));
+}
+
+/**
+ * Advise the page cache about the file range backing `[offset, offset + length)`
+ * of the view, e.g. `kDontNeed` evicts clean pages that `advise` would only unmap.
+ */
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFile<T, T2, T3>::fileAdvise(AdviceFlag flag, size_type offset, size_type length) {
     if (!isMapped()) [[unlikely]] { return kEnoUnmapped; }
     if (isAnon()) [[unlikely]] { return kEnoMapIsAnon; }
     if (m_length <= offset) [[unlikely]] { return kEnoInviArgs; }
-    if (m_length - offset < length) [[unlikely]] { length = m_length - offset; }
-    return _throwErrno(traits_type::sync(m_p_byte + offset, length));
+    if (m_length - offset < length) { length = m_length - offset; }
+    auto const head = off_type(m_p_byte - reinterpret_cast<pointer>(m_data.p_data_));
+    return _throwErrno(traits_type::fileAdvise(m_data.file_handle_,
+        m_data.offset_ + head + off_type(offset), length, flag));
+}
+
+/**
+ * Seal the backing memory file, e.g. `kImmutable | kSeal` before handing
+ * it to readers. Sealing `kWrite` needs this mapping to be read-only.
+ */
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFile<T, T2, T3>::seal(SealFlag flag) {
+    if (!isMapped()) [[unlikely]] { return kEnoUnmapped; }
+    if (isAnon()) [[unlikely]] { return kEnoMapIsAnon; }
+    return _throwErrno(traits_type::fileSeal(m_data.file_handle_, flag));
+}
+
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFile<T, T2, T3>::seals(SealFlag & flag) const {
+    flag = SealFlag::kNone;
+    if (!isMapped()) [[unlikely]] { return kEnoUnmapped; }
+    if (isAnon()) [[unlikely]] { return kEnoMapIsAnon; }
+    return _throwErrno(traits_type::fileSeals(m_data.file_handle_, flag));
 }
 
 template <typename T, typename T2, typename T3>
@@ -261,17 +465,27 @@ errno_t BasicMMapFile<T, T2, T3>::remap(
     if (!isMapped()) [[unlikely]] { return kEnoUnmapped; }
     if (isAnon()) [[unlikely]] { return kEnoMapIsAnon; }
 
+    auto const reserved = m_data.reserved_;
     if (!traits_type::unmap(m_data)) { return _throwErrno(false); }
+    m_data.reserved_ = reserved;
 
     auto en = _mapFileImpl(flag, length, offset);
     if (en) { _reset(); }
     return en;
 }
 
+/**
+ * A shared anonymous mapping can only shrink, or grow inside its
+ * reservation: pages past its original length have no backing and fault.
+ */
 template <typename T, typename T2, typename T3>
 errno_t BasicMMapFile<T, T2, T3>::resize(size_type new_length) {
     if (!isMapped()) [[unlikely]] { return kEnoUnmapped; }
     if (new_length == m_length) [[unlikely]] { return kEnoOk; }
+    if (new_length > m_length && _isAnon() && !m_data.reserved_ &&
+        !bool(m_data.access_ & AccessFlag::kCopy)) [[unlikely]] {
+        return kEnoUnsupported;
+    }
     auto offset = m_data.length_ - m_length;
     auto mapped_length = new_length + offset;
     auto en = _throwErrno(traits_type::remap(m_data, mapped_length));
@@ -283,33 +497,148 @@ errno_t BasicMMapFile<T, T2, T3>::resize(size_type new_length) {
 }
 
 template <typename T, typename T2, typename T3>
-errno_t BasicMMapFile<T, T2, T3>::lock() {
+errno_t BasicMMapFile<T, T2, T3>::lock(bool b_on_fault) {
     if (!isMapped()) [[unlikely]] { return kEnoUnmapped; }
+    if (b_on_fault) { return _throwErrno(traits_type::lockOnFault(m_data.p_data_, m_data.length_)); }
     return _throwErrno(traits_type::lock(m_data.p_data_, m_data.length_));
 }
 
+/**
+ * Lock the pages covering `[offset, offset + length)`. With `b_on_fault`
+ * pages are locked as they are faulted in instead of being populated now.
+ */
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFile<T, T2, T3>::lock(
+    size_type offset, size_type length, bool b_on_fault) {
+    void * addr = nullptr;
+    if (auto en = _pageRange(offset, length, addr, length)) { return en; }
+    if (b_on_fault) { return _throwErrno(traits_type::lockOnFault(addr, length)); }
+    return _throwErrno(traits_type::lock(addr, length));
+}
+
 template <typename T, typename T2, typename T3>
 errno_t BasicMMapFile<T, T2, T3>::unlock() {
     if (!isMapped()) [[unlikely]] { return kEnoUnmapped; }
     return _throwErrno(traits_type::unlock(m_data.p_data_, m_data.length_));
 }
 
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFile<T, T2, T3>::unlock(size_type offset, size_type length) {
+    void * addr = nullptr;
+    if (auto en = _pageRange(offset, length, addr, length)) { return en; }
+    return _throwErrno(traits_type::unlock(addr, length));
+}
+
 template <typename T, typename T2, typename T3>
 errno_t BasicMMapFile<T, T2, T3>::protect(AccessFlag flag) {
     if (!isMapped()) [[unlikely]] { return kEnoUnmapped; }
     return _throwErrno(traits_type::protect(m_data.p_data_, m_data.length_, flag));
 }
 
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFile<T, T2, T3>::protect(
+    AccessFlag flag, size_type offset, size_type length) {
+    void * addr = nullptr;
+    if (auto en = _pageRange(offset, length, addr, length)) { return en; }
+    return _throwErrno(traits_type::protect(addr, length, flag));
+}
+
 template <typename T, typename T2, typename T3>
 errno_t BasicMMapFile<T, T2, T3>::advise(AdviceFlag flag) {
 #ifdef _AYMMAP_UNIMPL_ADVISE
     return kEnoUnimpl;
 #else
     if (!isMapped()) [[unlikely]] { return kEnoUnmapped; }
+    if (!traits_type::isAdviceSupported(flag)) [[unlikely]] { return kEnoUnsupported; }
     return _throwErrno(traits_type::advise(m_data.p_data_, m_data.length_, flag));
 #endif
 }
 
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFile<T, T2, T3>::advise(
+    AdviceFlag flag, size_type offset, size_type length) {
+#ifdef _AYMMAP_UNIMPL_ADVISE
+    return kEnoUnimpl;
+#else
+    void * addr = nullptr;
+    if (auto en = _pageRange(offset, length, addr, length)) { return en; }
+    if (!traits_type::isAdviceSupported(flag)) [[unlikely]] { return kEnoUnsupported; }
+    return _throwErrno(traits_type::advise(addr, length, flag));
+#endif
+}
+
+/**
+ * Expand `[offset, offset + length)` of the view to the pages covering it,
+ * the length is clamped to the end of the view.
+ */
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFile<T, T2, T3>::_pageRange(size_type offset, size_type length,
+    void *& addr, size_type & page_length) const noexcept {
+    if (!isMapped()) [[unlikely]] { return kEnoUnmapped; }
+    if (m_length <= offset) [[unlikely]] { return kEnoInviArgs; }
+    if (m_length - offset < length) { length = m_length - offset; }
+
+    auto const page_size = bool(m_data.access_ & AccessFlag::_kHugeTLB) ?
+        m_data.page_size_ : static_cast<size_type>(utils_type::pageSize());
+    auto * const p_beg = reinterpret_cast<pointer>(m_data.p_data_);
+    auto const beg = size_type(m_p_byte - p_beg) + offset;
+    auto const aligned_beg = beg & ~(page_size - 1);
+    addr = p_beg + aligned_beg;
+    page_length = (beg - aligned_beg + length + page_size - 1) & ~(page_size - 1);
+    return kEnoOk;
+}
+
+/**
+ * Fault in the whole mapping ahead of use, splitting the range across
+ * `n_threads` threads. Fault counts are process wide, so they also include
+ * faults taken by unrelated threads during the call.
+ */
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFile<T, T2, T3>::prefault(
+    bool b_write, unsigned n_threads, PrefaultStats * p_stats) {
+    if (!isMapped()) [[unlikely]] { return kEnoUnmapped; }
+    if (b_write && !bool(m_data.access_ & AccessFlag::_kWrite)) [[unlikely]] { return kEnoInviArgs; }
+
+    std::uint64_t minor_beg{}, major_beg{};
+    bool const b_faults = traits_type::pageFaults(minor_beg, major_beg);
+    auto const time_beg = std::chrono::steady_clock::now();
+
+    auto * const p_beg = reinterpret_cast<pointer>(m_data.p_data_);
+    auto const length = m_data.length_;
+    auto const page_size  = static_cast<size_type>(utils_type::pageSize());
+    auto const page_count = (length + page_size - 1) / page_size;
+    if (n_threads == 0) { n_threads = 1; }
+    auto const chunk_pages = (page_count + n_threads - 1) / n_threads;
+    auto const chunk = chunk_pages * page_size;
+    n_threads = static_cast<unsigned>((page_count + chunk_pages - 1) / chunk_pages);
+
+    std::atomic<errno_t> first_en{kEnoOk};
+    auto task = [&](size_type beg) {
+        if (!traits_type::populate(p_beg + beg, std::min(chunk, length - beg), b_write)) {
+            errno_t en = kEnoOk;
+            first_en.compare_exchange_strong(en, traits_type::lastErrno());
+        }
+    };
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(n_threads - 1);
+        for (unsigned i = 1; i < n_threads; ++i) { workers.emplace_back(task, i * chunk); }
+        task(0);
+    }
+
+    if (p_stats) {
+        p_stats->length  = length;
+        p_stats->threads = n_threads;
+        p_stats->elapsed = std::chrono::steady_clock::now() - time_beg;
+        std::uint64_t minor_end{}, major_end{};
+        if (b_faults && traits_type::pageFaults(minor_end, major_end)) {
+            p_stats->minor_faults = minor_end - minor_beg;
+            p_stats->major_faults = major_end - major_beg;
+        }
+    }
+    return first_en.load();
+}
+
 template <typename T, typename T2, typename T3>
 void BasicMMapFile<T, T2, T3>::_reset() {
     m_p_byte = nullptr;
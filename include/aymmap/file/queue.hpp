@@ -0,0 +1,294 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "aymmap/file/mmap.hpp"
+
+namespace aymmap {
+namespace detail {
+inline constexpr std::size_t kCacheLineSize = 64;
+}
+
+/**
+ * Bounded lock-free MPMC queue living inside a shared mapping.
+ *
+ * The header and the slots are placed in the mapping itself, so every
+ * process mapping the same file (or inheriting the same shared anonymous
+ * mapping) sees one queue. Each slot carries a sequence number on its own
+ * cache line; producers and consumers only contend on the head and tail
+ * counters. Blocking `push` / `pop` spin on the lock-free path and fall back
+ * to futex wait/wake only while the queue is full or empty.
+ */
+template <typename T, typename FileT = MMapFile>
+class BasicMMapQueue {
+    static_assert(std::is_trivially_copyable_v<T>, "queue element must be trivially copyable");
+
+public:
+    using value_type  = T;
+    using file_type   = FileT;
+    using traits_type = typename file_type::traits_type;
+    using path_cref   = typename file_type::path_cref;
+    using size_type   = typename file_type::size_type;
+
+    static constexpr std::uint64_t kMagic   = 0x5545'5551'5041'4d59ull; // "YMAPQUEU"
+    static constexpr std::uint32_t kVersion = 1;
+
+private:
+    using _seq_type = std::atomic<std::uint64_t>;
+    using _ev_type  = std::atomic<std::uint32_t>;
+    static_assert(_seq_type::is_always_lock_free && _ev_type::is_always_lock_free);
+    static_assert(sizeof(_ev_type) == sizeof(std::uint32_t));
+
+    struct _Event {
+        _ev_type seq{0};
+        _ev_type waiters{0};
+    };
+
+    struct alignas(detail::kCacheLineSize) _Header {
+        std::uint64_t magic;
+        std::uint32_t version;
+        std::uint32_t slot_size;
+        std::uint64_t capacity;
+        alignas(detail::kCacheLineSize) _seq_type enqueue_pos{0};
+        alignas(detail::kCacheLineSize) _seq_type dequeue_pos{0};
+        alignas(detail::kCacheLineSize) _Event not_empty;
+        alignas(detail::kCacheLineSize) _Event not_full;
+    };
+
+    struct alignas(detail::kCacheLineSize) _Slot {
+        _seq_type  seq;
+        value_type value;
+    };
+
+public:
+    BasicMMapQueue() = default;
+    ~BasicMMapQueue() = default;
+    BasicMMapQueue(BasicMMapQueue && ot) noexcept { _move(std::move(ot)); }
+    BasicMMapQueue & operator=(BasicMMapQueue && ot) {
+        if (this != &ot) { _move(std::move(ot)); }
+        return *this;
+    }
+
+    // Bytes of mapping needed for `capacity` elements.
+    static constexpr size_type requiredSize(size_type capacity) noexcept {
+        return sizeof(_Header) + sizeof(_Slot) * capacity;
+    }
+
+    /**
+     * Create the queue in file `ph`, any previous content is discarded.
+     * `capacity` must be a power of two.
+     */
+    errno_t create(path_cref ph, size_type capacity) {
+        if (!_checkCapacity(capacity)) [[unlikely]] { return kEnoInviArgs; }
+        file_type fi;
+        if (auto en = fi.map(ph, AccessFlag::kDefault, requiredSize(capacity))) { return en; }
+        return _init(std::move(fi), capacity);
+    }
+
+    /**
+     * Create the queue in a shared anonymous mapping, usable across `fork`.
+     */
+    errno_t create(size_type capacity) {
+        if (!_checkCapacity(capacity)) [[unlikely]] { return kEnoInviArgs; }
+        file_type fi;
+        if (auto en = fi.anonMap(requiredSize(capacity), AccessFlag::kDefault)) { return en; }
+        return _init(std::move(fi), capacity);
+    }
+
+    /**
+     * Attach to a queue previously created in file `ph`, which must exist.
+     * `kEnoNotReady` while `create` has not finished yet; retry later.
+     */
+    errno_t open(path_cref ph) {
+        file_type fi;
+        auto en = fi.map(ph, AccessFlag::kReadWrite);
+        // an empty file cannot be mapped
+        if (en == kEnoInviArgs) [[unlikely]] { return kEnoNotReady; }
+        if (en) { return en; }
+        if (fi.size() < sizeof(_Header)) [[unlikely]] { return kEnoNotReady; }
+        auto * p_header = reinterpret_cast<_Header *>(fi.data());
+        auto const magic = std::atomic_ref<std::uint64_t>(p_header->magic)
+            .load(std::memory_order_acquire);
+        if (magic != kMagic) [[unlikely]] { return kEnoNotReady; }
+        if (p_header->version != kVersion ||
+            p_header->slot_size != sizeof(_Slot) ||
+            !_checkCapacity(p_header->capacity) ||
+            fi.size() < requiredSize(p_header->capacity)) [[unlikely]] {
+            return kEnoInviArgs;
+        }
+        _attach(std::move(fi));
+        return kEnoOk;
+    }
+
+    void close() noexcept {
+        m_file.unmap();
+        m_p_header = nullptr;
+        m_p_slots  = nullptr;
+        m_mask     = 0;
+    }
+
+    bool isOpen() const noexcept { return m_p_header != nullptr; }
+    file_type const & file() const noexcept { return m_file; }
+    size_type capacity() const noexcept { return isOpen() ? m_mask + 1 : 0; }
+    // Approximate while other threads are operating.
+    size_type size() const noexcept {
+        if (!isOpen()) { return 0; }
+        auto const tail = m_p_header->enqueue_pos.load(std::memory_order_relaxed);
+        auto const head = m_p_header->dequeue_pos.load(std::memory_order_relaxed);
+        return tail > head ? size_type(tail - head) : 0;
+    }
+    bool empty() const noexcept { return size() == 0; }
+
+    bool tryPush(value_type const & val) noexcept {
+        auto & tail = m_p_header->enqueue_pos;
+        auto pos = tail.load(std::memory_order_relaxed);
+        _Slot * p_slot;
+        while (true) {
+            p_slot = &m_p_slots[pos & m_mask];
+            auto const seq  = p_slot->seq.load(std::memory_order_acquire);
+            auto const diff = std::int64_t(seq - pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+        p_slot->value = val;
+        p_slot->seq.store(pos + 1, std::memory_order_release);
+        _notify(m_p_header->not_empty);
+        return true;
+    }
+
+    bool tryPop(value_type & val) noexcept {
+        auto & head = m_p_header->dequeue_pos;
+        auto pos = head.load(std::memory_order_relaxed);
+        _Slot * p_slot;
+        while (true) {
+            p_slot = &m_p_slots[pos & m_mask];
+            auto const seq  = p_slot->seq.load(std::memory_order_acquire);
+            auto const diff = std::int64_t(seq - (pos + 1));
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+        val = p_slot->value;
+        p_slot->seq.store(pos + m_mask + 1, std::memory_order_release);
+        _notify(m_p_header->not_full);
+        return true;
+    }
+
+    // Block while the queue is full.
+    void push(value_type const & val) noexcept {
+        _wait(m_p_header->not_full, [&] { return tryPush(val); });
+    }
+
+    // Block while the queue is empty.
+    void pop(value_type & val) noexcept {
+        _wait(m_p_header->not_empty, [&] { return tryPop(val); });
+    }
+
+private:
+    static constexpr bool _checkCapacity(size_type capacity) noexcept {
+        return capacity != 0 && (capacity & (capacity - 1)) == 0;
+    }
+
+    errno_t _init(file_type && fi, size_type capacity) {
+        // Publish `magic` last: `open` only trusts the other fields once it
+        // has seen it with acquire ordering.
+        auto * p_header = ::new (fi.data()) _Header{};
+        p_header->version   = kVersion;
+        p_header->slot_size = sizeof(_Slot);
+        p_header->capacity  = capacity;
+        auto * p_slots = reinterpret_cast<_Slot *>(p_header + 1);
+        for (size_type i = 0; i < capacity; ++i) {
+            ::new (static_cast<void *>(&p_slots[i].seq)) _seq_type(i);
+        }
+        std::atomic_ref<std::uint64_t>(p_header->magic).store(kMagic, std::memory_order_release);
+        _attach(std::move(fi));
+        return kEnoOk;
+    }
+
+    void _attach(file_type && fi) {
+        m_file     = std::move(fi);
+        m_p_header = reinterpret_cast<_Header *>(m_file.data());
+        m_p_slots  = reinterpret_cast<_Slot *>(m_p_header + 1);
+        m_mask     = size_type(m_p_header->capacity - 1);
+    }
+
+    void _move(BasicMMapQueue && ot) {
+        m_file     = std::move(ot.m_file);
+        m_p_header = std::exchange(ot.m_p_header, nullptr);
+        m_p_slots  = std::exchange(ot.m_p_slots, nullptr);
+        m_mask     = std::exchange(ot.m_mask, 0);
+    }
+
+    // The fence pairs with the one in `_wait`: either the waiter sees the
+    // new element, or the notifier sees the waiter.
+    static void _notify(_Event & ev) noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ev.waiters.load(std::memory_order_relaxed) == 0) [[likely]] { return; }
+        ev.seq.fetch_add(1, std::memory_order_relaxed);
+        traits_type::wakeAddress(_futexWord(ev), INT_MAX);
+    }
+
+    template <typename FnT>
+    static void _wait(_Event & ev, FnT && fn) noexcept {
+        constexpr int kSpinCount = 64;
+        for (int i = 0; i < kSpinCount; ++i) {
+            if (fn()) { return; }
+        }
+        while (true) {
+            auto const seq = ev.seq.load(std::memory_order_relaxed);
+            ev.waiters.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (fn()) {
+                ev.waiters.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+            traits_type::waitAddress(_futexWord(ev), seq);
+            ev.waiters.fetch_sub(1, std::memory_order_relaxed);
+            if (fn()) { return; }
+        }
+    }
+
+    static std::uint32_t * _futexWord(_Event & ev) noexcept {
+        return reinterpret_cast<std::uint32_t *>(&ev.seq);
+    }
+
+    _AYMMAP_DISABLE_CLASS_COPY(BasicMMapQueue)
+
+private:
+    file_type m_file;
+    _Header * m_p_header = nullptr;
+    _Slot *   m_p_slots  = nullptr;
+    size_type m_mask     = 0;
+};
+template <typename T>
+using MMapQueue = BasicMMapQueue<T, MMapFile>;
+}
@@ -0,0 +1,219 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+#include "aymmap/global.hpp"
+#include "aymmap/file/mman.hpp"
+#include "aymmap/file/utils.hpp"
+
+namespace aymmap {
+/**
+ * Single-producer single-consumer byte ring whose storage is mapped twice,
+ * back to back. Any `capacity` bytes starting inside the first copy are
+ * contiguous in memory, so wrapped records are read and written in place.
+ *
+ * The capacity is rounded up to the page size. The backing file is an
+ * anonymous `memfd` unless one is supplied.
+ */
+template <typename ByteT,
+    typename _TraitsT = MemMapTraits,
+    typename _UtilsT  = FileUtils<_TraitsT>
+>
+class BasicMMapRing : public _UtilsT {
+    static_assert(sizeof(ByteT) == sizeof(char));
+
+public:
+    using byte_type     = ByteT;
+    using pointer       = byte_type *;
+    using const_pointer = byte_type const *;
+
+    using traits_type = _TraitsT;
+    using handle_type = typename traits_type::handle_type;
+    using data_type   = typename traits_type::data_type;
+    using size_type   = typename traits_type::size_type;
+
+    using utils_type = _UtilsT;
+    using utils_type::_throwErrno;
+
+    using view_type = std::basic_string_view<byte_type>;
+
+    BasicMMapRing() = default;
+    ~BasicMMapRing() noexcept { close(); }
+
+    /**
+     * Create a ring over a new anonymous memory file.
+     */
+    errno_t create(size_type capacity, char const * name = "aymmap-ring") {
+        if (auto en = close()) { return en; }
+        auto handle = traits_type::memFileCreate(name);
+        if (!traits_type::checkHandle(handle)) [[unlikely]] { return _throwErrno(false); }
+        return _create(handle, capacity);
+    }
+
+    /**
+     * Create a ring over `file`, which is resized to the capacity. The
+     * handle is duplicated, the caller keeps ownership of `file`.
+     */
+    template <typename FileT>
+    errno_t create(FileT file, size_type capacity) {
+        if (auto en = close()) { return en; }
+        auto handle = utils_type::toFileHandle(file);
+        if (!traits_type::checkHandle(handle)) [[unlikely]] { return kEnoInviArgs; }
+        handle = traits_type::dupHandle(handle);
+        if (!traits_type::checkHandle(handle)) [[unlikely]] { return _throwErrno(false); }
+        return _create(handle, capacity);
+    }
+
+    errno_t close() noexcept {
+        if (!isOpen()) { return kEnoOk; }
+        auto handle = std::exchange(m_data.file_handle_, kInvalidHandle);
+        auto en = _throwErrno(traits_type::unmap(m_data));
+        traits_type::fileClose(handle);
+        m_capacity = 0;
+        m_head.store(0, std::memory_order_relaxed);
+        m_tail.store(0, std::memory_order_relaxed);
+        return en;
+    }
+
+    bool isOpen() const noexcept { return m_data.p_data_ != nullptr; }
+    size_type capacity() const noexcept { return m_capacity; }
+    // Bytes ready to read.
+    size_type size() const noexcept {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+    // Bytes free to write.
+    size_type space() const noexcept { return m_capacity - size(); }
+    bool empty() const noexcept { return size() == 0; }
+
+    /**
+     * Contiguous span for the next `length` written bytes, `nullptr` if the
+     * ring lacks the space. Publish the bytes with `commit`.
+     */
+    pointer prepare(size_type length) noexcept {
+        auto const tail = m_tail.load(std::memory_order_relaxed);
+        auto const head = m_head.load(std::memory_order_acquire);
+        if (length > m_capacity - (tail - head)) [[unlikely]] { return nullptr; }
+        return _at(tail);
+    }
+
+    void commit(size_type length) noexcept {
+        m_tail.fetch_add(length, std::memory_order_release);
+    }
+
+    /**
+     * Contiguous view of the next `length` readable bytes, `nullptr` if
+     * fewer are available. Release them with `consume`.
+     */
+    const_pointer peek(size_type length) const noexcept {
+        auto const head = m_head.load(std::memory_order_relaxed);
+        auto const tail = m_tail.load(std::memory_order_acquire);
+        if (length > tail - head) [[unlikely]] { return nullptr; }
+        return _at(head);
+    }
+
+    // All readable bytes as one view.
+    view_type readView() const noexcept {
+        auto const head = m_head.load(std::memory_order_relaxed);
+        auto const tail = m_tail.load(std::memory_order_acquire);
+        if (!isOpen()) [[unlikely]] { return {}; }
+        return view_type(_at(head), tail - head);
+    }
+
+    void consume(size_type length) noexcept {
+        m_head.fetch_add(length, std::memory_order_release);
+    }
+
+    // Write up to `length` bytes, return the count written.
+    size_type write(const_pointer data, size_type length) noexcept {
+        auto const tail = m_tail.load(std::memory_order_relaxed);
+        auto const head = m_head.load(std::memory_order_acquire);
+        length = std::min(length, m_capacity - (tail - head));
+        if (length == 0) { return 0; }
+        std::memcpy(_at(tail), data, length);
+        commit(length);
+        return length;
+    }
+
+    // Read up to `length` bytes, return the count read.
+    size_type read(pointer data, size_type length) noexcept {
+        auto const head = m_head.load(std::memory_order_relaxed);
+        auto const tail = m_tail.load(std::memory_order_acquire);
+        length = std::min(length, tail - head);
+        if (length == 0) { return 0; }
+        std::memcpy(data, _at(head), length);
+        consume(length);
+        return length;
+    }
+
+private:
+    pointer _at(size_type pos) const noexcept {
+        return static_cast<pointer>(m_data.p_data_) + pos % m_capacity;
+    }
+
+    /**
+     * Reserve twice the capacity of address space, then map the file over
+     * both halves. Takes ownership of `handle`.
+     */
+    errno_t _create(handle_type handle, size_type capacity) {
+        auto const page_size = size_type(utils_type::pageSize());
+        capacity = std::max((capacity + page_size - 1) & ~(page_size - 1), page_size);
+        if (!traits_type::fileResize(handle, capacity)) [[unlikely]] {
+            auto en = _throwErrno(false);
+            traits_type::fileClose(handle);
+            return en;
+        }
+
+        data_type d;
+        if (!traits_type::map(d, AccessFlag::kNoAccess | AccessFlag::kCopy, capacity * 2, 0)) [[unlikely]] {
+            auto en = _throwErrno(false);
+            traits_type::fileClose(handle);
+            return en;
+        }
+        auto * p_base = static_cast<pointer>(d.p_data_);
+        d.file_handle_ = handle;
+        if (!traits_type::mapFixed(d, p_base, AccessFlag::kReadWrite, capacity, 0) ||
+            !traits_type::mapFixed(d, p_base + capacity, AccessFlag::kReadWrite, capacity, 0)) [[unlikely]] {
+            auto en = _throwErrno(false);
+            d.file_handle_ = kInvalidHandle;
+            d.p_data_ = p_base;
+            d.length_ = capacity * 2;
+            traits_type::unmap(d);
+            traits_type::fileClose(handle);
+            return en;
+        }
+        d.p_data_ = p_base;
+        d.length_ = capacity * 2;
+        m_data = std::move(d);
+        m_capacity = capacity;
+        return kEnoOk;
+    }
+
+    _AYMMAP_DISABLE_CLASS_COPY(BasicMMapRing)
+
+private:
+    data_type m_data;
+    size_type m_capacity = 0;
+    alignas(64) std::atomic<size_type> m_head{0};
+    alignas(64) std::atomic<size_type> m_tail{0};
+};
+using MMapRing = BasicMMapRing<char>;
+}
@@ -0,0 +1,197 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "aymmap/detail/scan.hpp"
+#include "aymmap/file/mmap.hpp"
+
+namespace aymmap {
+struct ScanPolicy {
+    // nominal chunk length, rounded up to the page size
+    std::size_t chunk_size = std::size_t(4) << 20;
+    // worker count, all hardware threads if zero
+    unsigned threads = 0;
+    // chunks end right after a delimiter, so records are never split
+    bool b_snap = true;
+    char delimiter = '\n';
+    // chunks read ahead with `WILLNEED` as each one starts
+    std::size_t read_ahead = 2;
+};
+
+/**
+ * Parallel scan of a mapped file in chunks.
+ *
+ * Chunk boundaries start page-aligned and are moved forward past the next
+ * delimiter. Every worker owns a contiguous run of chunks and, once it is
+ * done, steals chunks from the back of the others' runs. Each worker
+ * accumulates into a result of its own; `mapReduce` combines them at the
+ * end. The mapping is advised `SEQUENTIAL` and chunks are prefetched with
+ * `WILLNEED` ahead of the workers.
+ */
+template <typename FileT = MMapFile>
+class BasicMMapScan {
+public:
+    using file_type = FileT;
+    using size_type = typename file_type::size_type;
+    using byte_type = typename file_type::byte_type;
+    using view_type = std::basic_string_view<byte_type>;
+
+    explicit BasicMMapScan(file_type & fi, ScanPolicy policy = ScanPolicy{})
+        : m_file(fi), m_policy(policy) { _split(); }
+
+    ScanPolicy const & policy() const noexcept { return m_policy; }
+    size_type chunkCount() const noexcept { return m_bounds.size() - 1; }
+    view_type chunk(size_type i) const noexcept {
+        return view_type(m_file.data() + m_bounds[i], m_bounds[i + 1] - m_bounds[i]);
+    }
+
+    /**
+     * Run `kernel(R & acc, view_type chunk)` over every chunk and fold the
+     * per-worker results with `reduce(R & into, R && from)`. Each worker
+     * starts from a copy of `init`, which must be the identity of `reduce`.
+     */
+    template <typename R, typename KernelT, typename ReduceT>
+    R mapReduce(R init, KernelT && kernel, ReduceT && reduce) {
+        auto const n_workers = _workerCount();
+        std::vector<_Acc<R>> results(n_workers, _Acc<R>{init});
+        _run(n_workers, [&](unsigned w, size_type i) { kernel(results[w].r, chunk(i)); });
+        for (auto & acc : results) { reduce(init, std::move(acc.r)); }
+        return init;
+    }
+
+    // Run `fn(view_type chunk, size_type index)` over every chunk.
+    template <typename FnT>
+    void forEach(FnT && fn) {
+        _run(_workerCount(), [&](unsigned, size_type i) { fn(chunk(i), i); });
+    }
+
+private:
+    // Run of chunk indices owned by a worker, packed as `beg << 32 | end`.
+    struct alignas(64) _Run {
+        std::atomic<std::uint64_t> range{0};
+    };
+
+    // Per-worker accumulator on its own cache line.
+    template <typename R>
+    struct alignas(64) _Acc {
+        R r;
+    };
+
+    static constexpr size_type kNone = static_cast<size_type>(-1);
+
+    void _split() {
+        auto const length = m_file.size();
+        auto const page_size = size_type(file_type::pageSize());
+        auto const chunk = std::max(page_size,
+            (size_type(m_policy.chunk_size) + page_size - 1) & ~(page_size - 1));
+        auto const * p_data = reinterpret_cast<char const *>(m_file.data());
+
+        m_bounds.assign(1, 0);
+        for (size_type beg = chunk; beg < length;) {
+            auto bound = beg;
+            if (m_policy.b_snap) {
+                auto const * found = detail::findByte(p_data + beg - 1, length - beg + 1, m_policy.delimiter);
+                // the rest of the file is one record
+                if (!found) { break; }
+                bound = size_type(found - p_data) + 1;
+            }
+            if (bound >= length) { break; }
+            m_bounds.push_back(bound);
+            // a record longer than a chunk swallows the next boundaries
+            beg = (bound / chunk + 1) * chunk;
+        }
+        m_bounds.push_back(length);
+    }
+
+    unsigned _workerCount() const noexcept {
+        auto n = m_policy.threads ? m_policy.threads : std::max(1u, std::thread::hardware_concurrency());
+        return unsigned(std::max<size_type>(1, std::min<size_type>(n, chunkCount())));
+    }
+
+    template <typename TaskT>
+    void _run(unsigned n_workers, TaskT && task) {
+        auto const count = chunkCount();
+        if (count == 0 || m_file.empty()) { return; }
+        m_file.advise(AdviceFlag::kSequential);
+
+        std::vector<_Run> runs(n_workers);
+        for (unsigned w = 0; w < n_workers; ++w) {
+            auto const beg = std::uint64_t(count * w / n_workers);
+            auto const end = std::uint64_t(count * (w + 1) / n_workers);
+            runs[w].range.store(beg << 32 | end, std::memory_order_relaxed);
+        }
+
+        auto worker = [&](unsigned w) {
+            while (true) {
+                auto i = _popFront(runs[w]);
+                for (unsigned k = 1; i == kNone && k < n_workers; ++k) {
+                    i = _popBack(runs[(w + k) % n_workers]);
+                }
+                if (i == kNone) { return; }
+                _readAhead(i);
+                task(w, i);
+            }
+        };
+        std::vector<std::jthread> workers;
+        workers.reserve(n_workers - 1);
+        for (unsigned w = 1; w < n_workers; ++w) { workers.emplace_back(worker, w); }
+        worker(0);
+    }
+
+    static size_type _popFront(_Run & run) noexcept {
+        auto cur = run.range.load(std::memory_order_relaxed);
+        while (true) {
+            auto const beg = cur >> 32, end = cur & 0xffff'ffffull;
+            if (beg >= end) { return kNone; }
+            if (run.range.compare_exchange_weak(cur, (beg + 1) << 32 | end, std::memory_order_relaxed)) {
+                return size_type(beg);
+            }
+        }
+    }
+
+    static size_type _popBack(_Run & run) noexcept {
+        auto cur = run.range.load(std::memory_order_relaxed);
+        while (true) {
+            auto const beg = cur >> 32, end = cur & 0xffff'ffffull;
+            if (beg >= end) { return kNone; }
+            if (run.range.compare_exchange_weak(cur, beg << 32 | (end - 1), std::memory_order_relaxed)) {
+                return size_type(end - 1);
+            }
+        }
+    }
+
+    void _readAhead(size_type i) noexcept {
+        if (m_policy.read_ahead == 0 || i + 1 >= chunkCount()) { return; }
+        auto const last = std::min(chunkCount(), i + 1 + size_type(m_policy.read_ahead));
+        auto const beg = m_bounds[i + 1];
+        m_file.advise(AdviceFlag::kWillNeed, beg, m_bounds[last] - beg);
+    }
+
+private:
+    file_type & m_file;
+    ScanPolicy  m_policy;
+    std::vector<size_type> m_bounds;
+};
+using MMapScan = BasicMMapScan<MMapFile>;
+}
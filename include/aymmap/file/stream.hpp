@@ -17,10 +17,15 @@
 
 #include "aymmap/detail/stream.hpp"
 #include "aymmap/file/buffer.hpp"
+#include "aymmap/file/window.hpp"
 
 namespace aymmap {
 template <Endian _endian = Endian::big, typename BufT = MMapFileBuf>
 using BasicMMapFileStream = BasicMMapStream<_endian, BufT>;
 using MMapFileStream = BasicMMapFileStream<>;
+
+template <Endian _endian = Endian::big, typename BufT = MMapFileWindow>
+using BasicMMapWindowStream = BasicMMapStream<_endian, BufT>;
+using MMapWindowStream = BasicMMapWindowStream<>;
 }
 
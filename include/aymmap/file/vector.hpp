@@ -0,0 +1,251 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "aymmap/file/mmap.hpp"
+
+namespace aymmap {
+/**
+ * Vector of trivially copyable elements stored in a mapping.
+ *
+ * Growth resizes the mapping (`mremap` on Linux), which extends it in place
+ * or moves its pages, elements are never copied. Unless `open`ed on a file,
+ * storage is a private anonymous mapping. A file-backed vector keeps its
+ * elements across runs: the file is trimmed to the element count on `close`
+ * and read back as elements by `open`. A vector opened read-only or
+ * copy-on-write never resizes its file: the first growth copies the
+ * elements into a private anonymous mapping.
+ *
+ * Errors are reported through return codes, growth invalidates pointers
+ * and iterators as with `std::vector`.
+ */
+template <typename T, typename FileT = MMapFile>
+class BasicMMapVector {
+    static_assert(std::is_trivially_copyable_v<T>, "vector element must be trivially copyable");
+
+public:
+    using value_type      = T;
+    using file_type       = FileT;
+    using traits_type     = typename file_type::traits_type;
+    using path_cref       = typename file_type::path_cref;
+    using size_type       = typename file_type::size_type;
+    using difference_type = std::ptrdiff_t;
+    using reference       = value_type &;
+    using const_reference = value_type const &;
+    using pointer         = value_type *;
+    using const_pointer   = value_type const *;
+    using iterator        = pointer;
+    using const_iterator  = const_pointer;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    BasicMMapVector() = default;
+    ~BasicMMapVector() noexcept { close(); }
+
+    BasicMMapVector(BasicMMapVector && ot) noexcept
+        : m_file(std::move(ot.m_file)), m_size(std::exchange(ot.m_size, 0)),
+          m_b_trim(std::exchange(ot.m_b_trim, false)) {}
+    BasicMMapVector & operator=(BasicMMapVector && ot) {
+        if (this != &ot) {
+            close();
+            m_file = std::move(ot.m_file);
+            m_size = std::exchange(ot.m_size, 0);
+            m_b_trim = std::exchange(ot.m_b_trim, false);
+        }
+        return *this;
+    }
+
+    /**
+     * Back the vector with file `ph`, its content becomes the elements.
+     */
+    errno_t open(path_cref ph, AccessFlag flag = AccessFlag::kDefault) {
+        if (auto en = close()) { return en; }
+        m_b_trim = bool(flag & AccessFlag::_kWrite) && !bool(flag & AccessFlag::kCopy);
+        auto en = m_file.map(ph, flag);
+        if (en == kEnoInviArgs) {
+            // new or empty file
+            en = m_file.map(ph, flag, _pageBytes(1));
+            if (!en) { m_size = 0; }
+            return en;
+        }
+        if (en) { return en; }
+        m_size = m_file.size() / sizeof(value_type);
+        return kEnoOk;
+    }
+
+    // Trim a file-backed vector to its elements and release the mapping.
+    errno_t close() noexcept {
+        if (!m_file.isMapped()) { return kEnoOk; }
+        errno_t en = kEnoOk;
+        if (!m_file.isAnon() && m_b_trim) {
+            auto const handle = traits_type::dupHandle(m_file.fileHandle());
+            if (auto en2 = m_file.unmap()) { en = en2; }
+            if (traits_type::checkHandle(handle)) {
+                if (!traits_type::fileResize(handle, m_size * sizeof(value_type))) {
+                    en = file_type::_throwErrno(false);
+                }
+                traits_type::fileClose(handle);
+            }
+        } else {
+            en = m_file.unmap();
+        }
+        m_size = 0;
+        m_b_trim = false;
+        return en;
+    }
+
+    errno_t flush(bool b_async = false) { return m_file.flush(b_async); }
+
+    file_type const & file() const noexcept { return m_file; }
+    bool isFileBacked() const noexcept { return m_file.isMapped() && !m_file.isAnon(); }
+
+    size_type size() const noexcept { return m_size; }
+    size_type capacity() const noexcept { return m_file.size() / sizeof(value_type); }
+    bool empty() const noexcept { return m_size == 0; }
+
+    pointer       data() noexcept { return reinterpret_cast<pointer>(m_file.data()); }
+    const_pointer data() const noexcept { return reinterpret_cast<const_pointer>(m_file.data()); }
+
+    iterator       begin() noexcept { return data(); }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    iterator       end() noexcept { return data() + m_size; }
+    const_iterator end() const noexcept { return data() + m_size; }
+    const_iterator cend() const noexcept { return end(); }
+    reverse_iterator       rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator       rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    reference       operator[](size_type i) noexcept { return data()[i]; }
+    const_reference operator[](size_type i) const noexcept { return data()[i]; }
+    reference       front() noexcept { return data()[0]; }
+    const_reference front() const noexcept { return data()[0]; }
+    reference       back() noexcept { return data()[m_size - 1]; }
+    const_reference back() const noexcept { return data()[m_size - 1]; }
+
+    /**
+     * Grow the capacity to at least `n` elements. A file-backed vector also
+     * allocates the file blocks, so writes through the mapping cannot hit
+     * a full disk later.
+     */
+    errno_t reserve(size_type n) {
+        if (n > capacity()) {
+            if (auto en = _grow(n)) { return en; }
+        }
+        if (isFileBacked()) {
+            auto const bytes = m_file.size();
+            if (!traits_type::fileAllocate(m_file.fileHandle(), 0, bytes)) {
+                return file_type::_throwErrno(false);
+            }
+        }
+        return kEnoOk;
+    }
+
+    // New elements are value-initialized.
+    errno_t resize(size_type n) {
+        if (n > m_size) {
+            if (n > capacity()) {
+                if (auto en = _grow(std::max(n, capacity() * 2))) { return en; }
+            }
+            std::uninitialized_value_construct(data() + m_size, data() + n);
+        }
+        m_size = n;
+        return kEnoOk;
+    }
+
+    errno_t resize(size_type n, value_type const & val) {
+        auto const old_size = m_size;
+        if (auto en = resize(n)) { return en; }
+        if (n > old_size) { std::fill(data() + old_size, data() + n, val); }
+        return kEnoOk;
+    }
+
+    errno_t push_back(value_type const & val) { return emplace_back(val); }
+
+    template <typename... Args>
+    errno_t emplace_back(Args &&... args) {
+        if (m_size == capacity()) [[unlikely]] {
+            if (auto en = _grow(std::max(m_size * 2, size_type(1)))) { return en; }
+        }
+        ::new (static_cast<void *>(data() + m_size)) value_type(std::forward<Args>(args)...);
+        ++m_size;
+        return kEnoOk;
+    }
+
+    errno_t append(const_pointer p, size_type n) {
+        if (m_size + n > capacity()) {
+            if (auto en = _grow(std::max(m_size + n, capacity() * 2))) { return en; }
+        }
+        std::memcpy(static_cast<void *>(data() + m_size), p, n * sizeof(value_type));
+        m_size += n;
+        return kEnoOk;
+    }
+
+    void pop_back() noexcept { --m_size; }
+    void clear() noexcept { m_size = 0; }
+
+    // Release the pages past the last element.
+    errno_t shrinkToFit() {
+        if (!m_file.isMapped()) { return kEnoOk; }
+        auto const bytes = _pageBytes(std::max(m_size, size_type(1)));
+        if (bytes >= m_file.size() || _isPrivateFile()) { return kEnoOk; }
+        return m_file.resize(bytes);
+    }
+
+private:
+    static size_type _pageBytes(size_type n) noexcept {
+        auto const page_size = size_type(file_type::pageSize());
+        return (n * sizeof(value_type) + page_size - 1) & ~(page_size - 1);
+    }
+
+    errno_t _grow(size_type n) {
+        auto const bytes = _pageBytes(n);
+        if (!m_file.isMapped()) { return m_file.anonMap(bytes, AccessFlag::kWriteCopy); }
+        if (_isPrivateFile()) { return _detach(bytes); }
+        return m_file.resize(bytes);
+    }
+
+    // Mapped from a file whose length must not change.
+    bool _isPrivateFile() const noexcept { return isFileBacked() && !m_b_trim; }
+
+    // Move the elements to an anonymous mapping of `bytes`.
+    errno_t _detach(size_type bytes) {
+        file_type fi;
+        if (auto en = fi.anonMap(bytes, AccessFlag::kWriteCopy)) { return en; }
+        std::memcpy(fi.data(), m_file.data(), m_size * sizeof(value_type));
+        if (auto en = m_file.unmap()) { return en; }
+        m_file = std::move(fi);
+        return kEnoOk;
+    }
+
+    _AYMMAP_DISABLE_CLASS_COPY(BasicMMapVector)
+
+private:
+    file_type m_file;
+    size_type m_size = 0;
+    bool      m_b_trim = false;
+};
+template <typename T>
+using MMapVector = BasicMMapVector<T, MMapFile>;
+}
@@ -0,0 +1,370 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+#include "aymmap/global.hpp"
+#include "aymmap/detail/scan.hpp"
+#include "aymmap/file/mman.hpp"
+#include "aymmap/file/utils.hpp"
+
+namespace aymmap {
+struct WindowPolicy {
+    // bytes mapped at once, rounded up to the page size
+    std::size_t window_size = std::size_t(64) << 20;
+    // bytes past the window to read ahead when sliding
+    std::size_t read_ahead = std::size_t(16) << 20;
+    // drop the pages left behind from the page cache when sliding forward
+    bool b_drop_behind = true;
+};
+
+/**
+ * Cursor over a file through a fixed-size, page-aligned mapped window.
+ *
+ * The window slides in place (same base address) as the cursor leaves it,
+ * so files larger than the address space or memory budget can be scanned.
+ * The interface matches `BasicMMapFileBuf` and `BasicMMapStream` can sit
+ * on top of it.
+ *
+ * Views returned by `readView` and `readline` are at most one window long
+ * and are invalidated when the window slides.
+ */
+template <typename ByteT,
+    typename _TraitsT = MemMapTraits,
+    typename _UtilsT  = FileUtils<_TraitsT>
+>
+class BasicMMapFileWindow : public _UtilsT {
+    static_assert(sizeof(ByteT) == sizeof(char));
+
+public:
+    using byte_type     = ByteT;
+    using pointer       = byte_type *;
+    using const_pointer = byte_type const *;
+
+    using traits_type = _TraitsT;
+    using handle_type = typename traits_type::handle_type;
+    using data_type   = typename traits_type::data_type;
+    using path_type   = typename traits_type::path_type;
+    using path_cref   = typename traits_type::path_cref;
+    using size_type   = typename traits_type::size_type;
+    using off_type    = typename traits_type::off_type;
+
+    using utils_type = _UtilsT;
+    using utils_type::_throwErrno;
+
+    using view_type = std::basic_string_view<byte_type>;
+
+    static constexpr auto npos = static_cast<size_type>(-1);
+
+    BasicMMapFileWindow() = default;
+    ~BasicMMapFileWindow() noexcept { unmap(); }
+
+    BasicMMapFileWindow(BasicMMapFileWindow && ot) noexcept { _move(std::move(ot)); }
+    BasicMMapFileWindow & operator=(BasicMMapFileWindow && ot) noexcept {
+        unmap();
+        _move(std::move(ot));
+        return *this;
+    }
+
+    errno_t map(path_cref, AccessFlag = AccessFlag::kReadOnly, WindowPolicy = WindowPolicy{});
+
+    template <typename FileT>
+    errno_t fileMap(FileT file, AccessFlag flag = AccessFlag::kReadOnly,
+        bool b_dup = true, WindowPolicy policy = WindowPolicy{}) {
+        unmap();
+        return _fileMap(utils_type::toFileHandle(file), flag, b_dup, policy);
+    }
+
+    errno_t unmap() noexcept;
+
+    bool isMapped() const noexcept { return bool(m_data.p_data_); }
+    handle_type fileHandle() const noexcept { return m_data.file_handle_; }
+    WindowPolicy const & policy() const noexcept { return m_policy; }
+    // Error of the last failed slide, reads and writes stop after one.
+    errno_t lastError() const noexcept { return m_errno; }
+
+    // File offset and length of the current window.
+    size_type windowOffset() const noexcept { return size_type(m_data.offset_); }
+    size_type windowSize() const noexcept { return m_data.length_; }
+
+    bool isEOF() const noexcept { return m_pos >= size(); }
+    size_type size() const noexcept { return m_size; }
+    size_type tell() const noexcept { return m_pos; }
+    size_type remaining() const noexcept { return tell() < size() ? size() - tell() : 0; }
+
+    size_type seek(off_type offset, BufferPos whence = BufferPos::kCur) noexcept {
+        m_pos = _getPos(offset, whence);
+        return m_pos;
+    }
+
+    // Sync the current window and the pages written through earlier ones.
+    bool flush() noexcept {
+        if (!isMapped()) [[unlikely]] { return false; }
+        if (!traits_type::sync(m_data.p_data_, m_data.length_)) { return false; }
+        return traits_type::fileSync(m_data.file_handle_);
+    }
+
+    size_type read(pointer data, size_type length = npos) noexcept {
+        assert(data);
+        size_type total = 0;
+        while (total < length && !isEOF()) {
+            size_type avail = 0;
+            auto p = _at(m_pos, 1, avail);
+            if (!p) [[unlikely]] { break; }
+            avail = std::min(avail, length - total);
+            std::memcpy(data + total, p, avail);
+            total += avail;
+            m_pos += avail;
+        }
+        return total;
+    }
+
+    size_type readByte(byte_type & data) noexcept {
+        size_type avail = 0;
+        auto p = isEOF() ? nullptr : _at(m_pos, 1, avail);
+        if (!p) [[unlikely]] {
+            data = byte_type{0};
+            return 0;
+        }
+        data = *p;
+        ++m_pos;
+        return 1;
+    }
+
+    view_type readView(size_type length = npos) noexcept {
+        if (isEOF()) [[unlikely]] { return view_type{}; }
+        length = std::min(length, remaining());
+        size_type avail = 0;
+        auto p = _at(m_pos, length, avail);
+        if (!p) [[unlikely]] { return view_type{}; }
+        length = std::min(length, avail);
+        m_pos += length;
+        return view_type{p, length};
+    }
+
+    view_type readline(byte_type sep = '\n') noexcept {
+        if (isEOF()) [[unlikely]] { return view_type{}; }
+        size_type avail = 0;
+        auto p = _at(m_pos, 1, avail);
+        if (!p) [[unlikely]] { return view_type{}; }
+        auto found = detail::findByte<byte_type>(p, avail, sep);
+        if (!found && m_pos + avail < size()) {
+            // the line crosses the window, restart the window at the line
+            p = _at(m_pos, m_data.length_, avail);
+            if (!p) [[unlikely]] { return view_type{}; }
+            found = detail::findByte<byte_type>(p, avail, sep);
+        }
+        size_type length = found ? size_type(found - p) + 1 : avail;
+        m_pos += length;
+        return view_type{p, length};
+    }
+
+    size_type write(const_pointer data, size_type length) noexcept {
+        assert(data);
+        size_type total = 0;
+        while (total < length && !isEOF()) {
+            size_type avail = 0;
+            auto p = _at(m_pos, 1, avail);
+            if (!p) [[unlikely]] { break; }
+            avail = std::min(avail, length - total);
+            std::memcpy(p, data + total, avail);
+            total += avail;
+            m_pos += avail;
+        }
+        return total;
+    }
+
+    size_type writeByte(byte_type byte) noexcept {
+        size_type avail = 0;
+        auto p = isEOF() ? nullptr : _at(m_pos, 1, avail);
+        if (!p) [[unlikely]] { return 0; }
+        *p = byte;
+        ++m_pos;
+        return 1;
+    }
+
+    size_type writeView(view_type view) noexcept {
+        return write(view.data(), view.size());
+    }
+
+private:
+    errno_t _fileMap(handle_type, AccessFlag, bool, WindowPolicy);
+    errno_t _mapImpl(AccessFlag, WindowPolicy);
+    errno_t _slide(size_type pos) noexcept;
+
+    /**
+     * Pointer to `pos` with at least `need` bytes behind it in the window
+     * when possible, `avail` receives the bytes actually available.
+     */
+    pointer _at(size_type pos, size_type need, size_type & avail) noexcept {
+        auto beg = windowOffset();
+        auto const win_end = beg + m_data.length_;
+        if (pos < beg || pos >= win_end ||
+            (pos + need > win_end && utils_type::alignToPageSize(off_type(pos)) != off_type(beg))) {
+            if (_slide(pos)) [[unlikely]] { return nullptr; }
+            beg = windowOffset();
+        }
+        avail = std::min(beg + m_data.length_, size()) - pos;
+        return reinterpret_cast<pointer>(m_data.p_data_) + (pos - beg);
+    }
+
+    void _move(BasicMMapFileWindow && ot) noexcept {
+        m_data   = std::move(ot.m_data);
+        m_flag   = std::exchange(ot.m_flag, AccessFlag{});
+        m_policy = ot.m_policy;
+        m_size   = std::exchange(ot.m_size, 0);
+        m_pos    = std::exchange(ot.m_pos, 0);
+        m_errno  = std::exchange(ot.m_errno, kEnoOk);
+        m_b_internal_file = std::exchange(ot.m_b_internal_file, false);
+    }
+
+    size_type _getPos(off_type offset, BufferPos whence) noexcept {
+        switch (whence) {
+        case BufferPos::kBeg:
+            if (offset <= 0) [[unlikely]] { return 0; }
+            if (size_type(offset) > size()) { return size(); }
+            return (size_type)offset;
+        case BufferPos::kEnd:
+            if (offset >= 0) [[unlikely]] { return size(); }
+            if (size_type(-offset) >= size()) { return 0; }
+            return size() + offset;
+        case BufferPos::kCur:
+            [[fallthrough]];
+        default:
+            if (offset <= 0) {
+                if (size_type(-offset) >= m_pos) { return 0; }
+                return m_pos + offset;
+            }
+            if (m_pos >= size()) [[unlikely]] { return size(); }
+            if (size() - m_pos <= size_type(offset)) { return size(); }
+            return m_pos + offset;
+        }
+    }
+
+    _AYMMAP_DISABLE_CLASS_COPY(BasicMMapFileWindow)
+
+private:
+    data_type    m_data;
+    AccessFlag   m_flag{};
+    WindowPolicy m_policy;
+    size_type    m_size  = 0;
+    size_type    m_pos   = 0;
+    errno_t      m_errno = kEnoOk;
+    bool         m_b_internal_file = false;
+};
+using MMapFileWindow = BasicMMapFileWindow<char>;
+
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFileWindow<T, T2, T3>::map(path_cref ph, AccessFlag flag, WindowPolicy policy) {
+    unmap();
+    auto file_handle = traits_type::fileOpen(ph, flag);
+    if (!traits_type::checkHandle(file_handle)) [[unlikely]] { return _throwErrno(false); }
+    m_data.file_handle_ = file_handle;
+    m_b_internal_file   = true;
+    auto en = _mapImpl(flag, policy);
+    if (en) { unmap(); }
+    return en;
+}
+
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFileWindow<T, T2, T3>::_fileMap(handle_type file_handle,
+    AccessFlag flag, bool b_dup, WindowPolicy policy) {
+    if (!traits_type::checkHandle(file_handle)) [[unlikely]] { return kEnoInviArgs; }
+    if (b_dup) {
+        auto dup_handle = traits_type::dupHandle(file_handle);
+        if (!traits_type::checkHandle(dup_handle)) { return _throwErrno(false); }
+        m_data.file_handle_ = dup_handle;
+        m_b_internal_file   = true;
+    } else {
+        m_data.file_handle_ = file_handle;
+    }
+    auto en = _mapImpl(flag, policy);
+    if (en) { unmap(); }
+    return en;
+}
+
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFileWindow<T, T2, T3>::_mapImpl(AccessFlag flag, WindowPolicy policy) {
+    m_size = utils_type::fileSize(m_data.file_handle_);
+    if (m_size == 0) [[unlikely]] { return kEnoInviArgs; }
+
+    auto const page_size = size_type(utils_type::pageSize());
+    auto window_size = std::max(policy.window_size, page_size);
+    window_size = std::min(window_size, m_size);
+    policy.window_size = (window_size + page_size - 1) & ~(page_size - 1);
+
+    // huge pages cannot slide with `mapFixed`
+    flag = flag & ~AccessFlag::kHugeTLB1GB & ~AccessFlag::kHugeTLB2MB
+                & ~AccessFlag::kTransHuge & ~AccessFlag::kAlignHuge;
+    if (!traits_type::map(m_data, flag, policy.window_size, 0)) { return _throwErrno(false); }
+    m_flag   = flag;
+    m_policy = policy;
+    m_pos    = 0;
+    m_errno  = kEnoOk;
+    if (m_policy.read_ahead) {
+        traits_type::fileAdvise(m_data.file_handle_, 0,
+            m_policy.window_size + m_policy.read_ahead, AdviceFlag::kWillNeed);
+    }
+    return kEnoOk;
+}
+
+/**
+ * Move the window to the page containing `pos` at the same address.
+ */
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFileWindow<T, T2, T3>::_slide(size_type pos) noexcept {
+    if (m_errno) [[unlikely]] { return m_errno; }
+    auto const old_offset = m_data.offset_;
+    auto const length     = m_data.length_;
+    auto const new_offset = utils_type::alignToPageSize(off_type(pos));
+
+    if (!traits_type::mapFixed(m_data, m_data.p_data_, m_flag, length, new_offset)) {
+        m_errno = _throwErrno(false);
+        AYMMAP_DEBUG("Failed to slide the window: ", m_errno);
+        return m_errno;
+    }
+
+    auto const handle = m_data.file_handle_;
+    if (m_policy.b_drop_behind && new_offset > old_offset) {
+        auto const drop_end = std::min(old_offset + off_type(length), new_offset);
+        traits_type::fileAdvise(handle, old_offset, size_type(drop_end - old_offset),
+            AdviceFlag::kDontNeed);
+    }
+    if (m_policy.read_ahead) {
+        traits_type::fileAdvise(handle, new_offset, length + m_policy.read_ahead,
+            AdviceFlag::kWillNeed);
+    }
+    return kEnoOk;
+}
+
+template <typename T, typename T2, typename T3>
+errno_t BasicMMapFileWindow<T, T2, T3>::unmap() noexcept {
+    if (isMapped() && !traits_type::unmap(m_data)) { return _throwErrno(false); }
+    if (m_b_internal_file) {
+        traits_type::fileClose(m_data.file_handle_);
+        m_b_internal_file = false;
+    }
+    m_data.file_handle_ = kInvalidHandle;
+    m_size  = 0;
+    m_pos   = 0;
+    m_errno = kEnoOk;
+    return kEnoOk;
+}
+}
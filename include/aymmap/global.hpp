@@ -68,6 +68,15 @@ enum class AccessFlag : std::uint32_t {
     kResize  = _kResize | _kWrite,
     kNoAccess = 0x0040,
 
+    // huge page options, see `MemMapTraits::hugePageSize`
+    _kHugeTLB   = 0x0080,
+    kHugeTLB    = _kHugeTLB,
+    kHugeTLB2MB = _kHugeTLB | 0x0100,
+    kHugeTLB1GB = _kHugeTLB | 0x0200,
+    kTransHuge  = 0x0400,
+    kAlignHuge  = 0x0800,
+    kPopulate   = 0x1000,
+
     kDefault   = kWrite | kCreate,
     kReadOnly  = kRead,
     kReadWrite = kWrite,
@@ -82,7 +91,35 @@ enum class AdviceFlag {
     kSequential,
     kWillNeed,
     kDontNeed,
+    kFree,
+    kCold,
+    kPageOut,
+    kHugePage,
+    kNoHugePage,
+    kMergeable,
+    kUnmergeable,
+    kPopulateRead,
+    kPopulateWrite,
+    kDontFork,
+    kDoFork,
+    kDontDump,
+    kDoDump,
+    _kCount,
+};
+
+// seals of a memory file, see `MemMapTraits::fileSeal`
+enum class SealFlag : std::uint32_t {
+    kNone        = 0x0000,
+    kSeal        = 0x0001,
+    kShrink      = 0x0002,
+    kGrow        = 0x0004,
+    kWrite       = 0x0008,
+    kFutureWrite = 0x0010,
+
+    kResize    = kShrink | kGrow,
+    kImmutable = kResize | kWrite,
 };
+_AYMMAP_DECL_ENUM_OP(SealFlag)
 
 enum class BufferPos {
     kBeg = 0,
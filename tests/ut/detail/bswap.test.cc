@@ -0,0 +1,39 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <vector>
+
+#include "testlib.h"
+#include "aymmap/detail/bswap.hpp"
+
+using namespace aymmap;
+
+TEST_CASE("byteswap copy") {
+    // lengths around the vector block sizes, copied and in place
+    auto check = [&]<typename T>(T) {
+        for (std::size_t n = 0; n < 80; ++n) {
+            std::vector<T> src(n), dst(n);
+            for (std::size_t i = 0; i < n; ++i) { src[i] = T(0x0123456789abcdefull * (i + 1)); }
+            detail::byteswapCopy(dst.data(), src.data(), n, sizeof(T));
+            for (std::size_t i = 0; i < n; ++i) { CHECK(dst[i] == detail::byteswap(src[i])); }
+            detail::byteswapCopy(dst.data(), dst.data(), n, sizeof(T));
+            CHECK(dst == src);
+        }
+    };
+    check(std::uint16_t{});
+    check(std::uint32_t{});
+    check(std::uint64_t{});
+}
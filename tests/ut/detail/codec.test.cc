@@ -0,0 +1,64 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "testlib.h"
+#include "aymmap/detail/codec.hpp"
+
+using namespace aymmap;
+
+TEST_CASE("zigzag varint") {
+    CHECK(detail::zigzagEncode(std::int32_t(0)) == 0u);
+    CHECK(detail::zigzagEncode(std::int32_t(-1)) == 1u);
+    CHECK(detail::zigzagEncode(std::int32_t(1)) == 2u);
+    CHECK(detail::zigzagDecode<std::int64_t>(detail::zigzagEncode(std::numeric_limits<std::int64_t>::min()))
+        == std::numeric_limits<std::int64_t>::min());
+
+    unsigned char bytes[detail::kMaxVarintSize];
+    for (std::uint64_t n : {std::uint64_t(0), std::uint64_t(127), std::uint64_t(128),
+            std::uint64_t(300), ~std::uint64_t(0)}) {
+        auto const length = detail::encodeVarint(n, bytes);
+        std::uint64_t out = 1;
+        CHECK(detail::decodeVarint(bytes, bytes + length, out) == length);
+        CHECK(out == n);
+        // truncated input
+        CHECK(detail::decodeVarint(bytes, bytes + length - 1, out) == 0);
+    }
+}
+
+TEST_CASE("bit packing") {
+    std::vector<std::uint32_t> deltas(detail::kPackBlock), out(detail::kPackBlock);
+    std::vector<unsigned char> packed(detail::packedBlockSize(32));
+    for (unsigned width = 0; width <= 32; ++width) {
+        auto const mask = width == 32 ? ~std::uint32_t(0) : (std::uint32_t(1) << width) - 1;
+        for (std::size_t i = 0; i < deltas.size(); ++i) {
+            deltas[i] = std::uint32_t(i * 2654435761u) & mask;
+        }
+        deltas[7] = mask;
+        CHECK(detail::packWidth(deltas.data()) == width);
+        detail::packBlock(deltas.data(), width, packed.data());
+        detail::unpackBlock(packed.data(), width, 5, out.data());
+        bool b_same = true;
+        for (std::size_t i = 0; i < deltas.size(); ++i) { b_same &= out[i] == deltas[i] + 5; }
+        CHECK(b_same);
+        detail::_unpackBlockScalar(packed.data(), width, 5, out.data());
+        b_same = true;
+        for (std::size_t i = 0; i < deltas.size(); ++i) { b_same &= out[i] == deltas[i] + 5; }
+        CHECK(b_same);
+    }
+}
@@ -0,0 +1,43 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <cstring>
+
+#include "testlib.h"
+#include "aymmap/detail/endian.hpp"
+
+using namespace aymmap;
+
+TEST_CASE("endian scalar") {
+    static_assert(sizeof(be_u32) == 4 && alignof(be_u32) == 1);
+    static_assert(std::is_trivially_copyable_v<le_f64>);
+
+    unsigned char bytes[9] = {};
+    auto * p_be = reinterpret_cast<be_u32 *>(bytes + 1);
+    *p_be = 0x01020304u;
+    CHECK(bytes[1] == 0x01);
+    CHECK(bytes[4] == 0x04);
+    CHECK(std::uint32_t(*p_be) == 0x01020304u);
+
+    auto * p_le = reinterpret_cast<le_i16 *>(bytes + 5);
+    *p_le = -2;
+    CHECK(bytes[5] == 0xfe);
+    CHECK(bytes[6] == 0xff);
+    CHECK(p_le->load() == -2);
+
+    be_f64 d = 1.5;
+    CHECK(double(d) == 1.5);
+}
@@ -0,0 +1,91 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <vector>
+#include <utility>
+
+#include "testlib.h"
+#include "aymmap/detail/interval.hpp"
+
+using namespace aymmap;
+
+using Intervals = std::vector<std::pair<unsigned, unsigned>>;
+
+static Intervals toVector(detail::IntervalSet<unsigned> const & set) {
+    return Intervals(set.begin(), set.end());
+}
+
+TEST_CASE("interval set") {
+    detail::IntervalSet<unsigned> set;
+    CHECK(set.empty());
+
+    SECTION("sequential") {
+        for (unsigned i = 0; i < 10; ++i) { set.add(i, i + 1); }
+        CHECK(toVector(set) == Intervals{{0, 10}});
+    }
+
+    SECTION("disjoint") {
+        set.add(10, 20);
+        set.add(0, 5);
+        set.add(30, 40);
+        set.add(10, 12);
+        CHECK(toVector(set) == Intervals{{0, 5}, {10, 20}, {30, 40}});
+    }
+
+    SECTION("merge") {
+        set.add(10, 20);
+        set.add(30, 40);
+        set.add(0, 5);
+        set.add(5, 10);
+        CHECK(toVector(set) == Intervals{{0, 20}, {30, 40}});
+        CHECK(set.length() == 30);
+        set.add(15, 35);
+        CHECK(toVector(set) == Intervals{{0, 40}});
+        CHECK(set.length() == 40);
+    }
+
+    SECTION("fast path") {
+        set.add(0, 5);
+        set.add(8, 10);
+        set.add(0, 8);
+        CHECK(toVector(set) == Intervals{{0, 10}});
+        set.add(20, 21);
+        set.add(21, 22);
+        CHECK(toVector(set) == Intervals{{0, 10}, {20, 22}});
+        CHECK(set.length() == 12);
+    }
+
+    SECTION("empty interval") {
+        set.add(5, 5);
+        set.add(6, 2);
+        CHECK(set.empty());
+    }
+
+    SECTION("erase and move") {
+        set.add(0, 5);
+        set.add(10, 15);
+        set.erase(set.begin());
+        CHECK(toVector(set) == Intervals{{10, 15}});
+        CHECK(set.length() == 5);
+
+        auto set2 = std::move(set);
+        CHECK(set.empty());
+        set2.add(15, 20);
+        CHECK(toVector(set2) == Intervals{{10, 20}});
+        CHECK(set2.length() == 10);
+        set2.clear();
+        CHECK(set2.empty() && set2.length() == 0);
+    }
+}
@@ -0,0 +1,74 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <array>
+#include <cstdint>
+
+#include "testlib.h"
+#include "aymmap/detail/layout.hpp"
+
+namespace {
+enum class Side : std::uint8_t { kBuy = 1, kSell = 2 };
+
+struct Flat {
+    std::uint32_t a;
+    std::int32_t  b;
+    float         c[2];
+};
+
+struct Padded {
+    std::uint8_t  tag;
+    std::uint64_t value;
+    Side          side;
+    Flat          flat;
+};
+
+struct Reordered {
+    std::uint32_t a;
+    std::uint32_t b;
+};
+}
+
+AYMMAP_STREAM_LAYOUT(Flat, a, b, c)
+AYMMAP_STREAM_LAYOUT(Padded, tag, value, side, flat)
+AYMMAP_STREAM_LAYOUT(Reordered, b, a)
+
+using namespace aymmap;
+
+TEST_CASE("stream layout") {
+    static_assert(detail::kStreamSize<Flat> == 16);
+    static_assert(detail::kStreamSize<Padded> == 1 + 8 + 1 + 16);
+    CHECK(detail::isFlatLayout<Flat>());
+    CHECK(!detail::isFlatLayout<Padded>());
+    CHECK(!detail::isFlatLayout<Reordered>());
+
+    Padded in{7, 0x0102030405060708ull, Side::kSell, {1, -2, {0.5f, 1.5f}}};
+    unsigned char bytes[detail::kStreamSize<Padded>];
+    auto * out = bytes;
+    detail::encodeField<Endian::big>(in, out);
+    CHECK(out == bytes + sizeof(bytes));
+    CHECK(bytes[0] == 7);
+    CHECK(bytes[1] == 0x01);
+    CHECK(bytes[8] == 0x08);
+    CHECK(bytes[9] == 2);
+
+    Padded back{};
+    auto const * p = bytes;
+    detail::decodeField<Endian::big>(p, back);
+    CHECK(back.value == in.value);
+    CHECK(back.side == Side::kSell);
+    CHECK(back.flat.b == -2);
+    CHECK(back.flat.c[1] == 1.5f);
+}
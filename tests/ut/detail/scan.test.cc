@@ -0,0 +1,67 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "testlib.h"
+#include "aymmap/detail/scan.hpp"
+
+using namespace aymmap;
+
+TEST_CASE("find byte") {
+    // every position around the vector block sizes
+    for (std::size_t n = 1; n < 200; ++n) {
+        std::string text(n, 'a');
+        CHECK(detail::findByte(text.data(), n, '\n') == nullptr);
+        for (std::size_t i = 0; i < n; i += 7) {
+            text[i] = '\n';
+            CHECK(detail::findByte(text.data(), n, '\n') == text.data() + i);
+            text[i] = 'a';
+        }
+    }
+    CHECK(detail::findByte("", 0, '\n') == nullptr);
+}
+
+TEST_CASE("find each") {
+    std::string text;
+    std::vector<std::size_t> expected;
+    for (std::size_t i = 0; i < 300; ++i) {
+        text.append(i % 13, 'x');
+        expected.push_back(text.size());
+        text.push_back(',');
+    }
+    text.append("tail");
+
+    std::vector<std::size_t> offsets(expected.size() + 1);
+    auto count = detail::findEach(text.data(), text.size(), ',', offsets.data(), offsets.size());
+    CHECK(count == expected.size());
+    offsets.resize(count);
+    CHECK(offsets == expected);
+
+    count = detail::findEach(text.data(), text.size(), ',', offsets.data(), 5);
+    CHECK(count == 5);
+    CHECK(offsets[4] == expected[4]);
+}
+
+TEST_CASE("line range") {
+    std::string_view text = "a\nbb\n\nccc";
+    std::vector<std::string_view> lines;
+    for (auto line : detail::LineRange<char>(text, '\n')) { lines.push_back(line); }
+    CHECK(lines == std::vector<std::string_view>{"a\n", "bb\n", "\n", "ccc"});
+
+    CHECK(detail::LineRange<char>().begin() == detail::LineRange<char>().end());
+}
@@ -0,0 +1,89 @@
+/**
+ * Copyright 2025 NoEvaa
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string>
+#include <utility>
+
+#include "testlib.h"
+#include "aymmap/aymmap.hpp"
+
+using namespace aymmap;
+
+TEST_CASE("buffer set file") {
+    MMapFile fi;
+    REQUIRE(fi.anonMap(4096) == kEnoOk);
+    auto * const p_data = fi.data();
+
+    MMapFileBuf buf;
+    auto old = buf.setFile(std::move(fi));
+    CHECK(!old.isMapped());
+    CHECK(buf.file().data() == p_data);
+    CHECK(buf.size() == 4096);
+    CHECK(buf.writeByte('x') == 1);
+    CHECK(buf.tell() == 1);
+
+    old = buf.setFile();
+    CHECK(old.data() == p_data);
+    CHECK(!buf.file().isMapped());
+    CHECK(buf.size() == 0);
+    CHECK(buf.tell() == 0);
+}
+
+TEST_CASE("anonymous buffer growth") {
+    MMapFileBuf buf;
+    buf.setGrowthPolicy(GrowthPolicy{.kind = GrowthKind::kGeometric});
+    std::string const block(10000, 'x');
+    MMapFile fi;
+
+    SECTION("private") {
+        REQUIRE(fi.anonMap(4096, AccessFlag::kWriteCopy) == kEnoOk);
+        buf.setFile(std::move(fi));
+        CHECK(buf.write(block.data(), block.size()) == block.size());
+        CHECK(buf.capacity() >= block.size());
+        CHECK(buf.file().data()[block.size() - 1] == 'x');
+    }
+
+    SECTION("shared") {
+        // pages past the old end of a shared anonymous mapping have no backing
+        REQUIRE(fi.anonMap(4096) == kEnoOk);
+        buf.setFile(std::move(fi));
+        CHECK(buf.write(block.data(), block.size()) == 4096);
+        CHECK(buf.capacity() == 4096);
+        CHECK(buf.file().resize(12288) == kEnoUnsupported);
+        CHECK(buf.file().resize(2048) == kEnoOk);
+    }
+}
+
+TEST_CASE("buffer close trims to the logical length") {
+    auto const ph = fs::path("buffer.test.txt");
+    MMapFileBuf buf;
+    buf.setGrowthPolicy(GrowthPolicy{.kind = GrowthKind::kGeometric});
+    REQUIRE(buf.map(ph, AccessFlag::kDefault, 4096) == kEnoOk);
+    buf.truncate(0);
+
+    SECTION("empty") {
+        CHECK(buf.close() == kEnoOk);
+        CHECK(fs::file_size(ph) == 0);
+    }
+
+    SECTION("grown") {
+        std::string const block(10000, 'x');
+        CHECK(buf.write(block.data(), block.size()) == block.size());
+        buf.truncate(100);
+        CHECK(buf.close() == kEnoOk);
+        CHECK(fs::file_size(ph) == 100);
+    }
+    fs::remove(ph);
+}
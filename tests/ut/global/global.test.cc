@@ -31,3 +31,13 @@ TEST_CASE("access flag") {
     CHECK(AccessFlag::kWrite == (AccessFlag::kWriteCopy ^ AccessFlag::kCopy));
 }
 
+
+TEST_CASE("huge page flag") {
+    CHECK(AccessFlag::kHugeTLB2MB & AccessFlag::kHugeTLB);
+    CHECK(AccessFlag::kHugeTLB1GB & AccessFlag::kHugeTLB);
+    CHECK(!bool(AccessFlag::kHugeTLB2MB & AccessFlag::kHugeTLB1GB & ~AccessFlag::kHugeTLB));
+    CHECK(!bool(AccessFlag::kDefault & AccessFlag::kHugeTLB1GB));
+    CHECK(!bool(AccessFlag::kDefault & AccessFlag::kTransHuge));
+    CHECK(!bool(AccessFlag::kDefault & AccessFlag::kAlignHuge));
+    CHECK(!bool(AccessFlag::kNoAccess & (AccessFlag::kHugeTLB1GB | AccessFlag::kHugeTLB2MB)));
+}